@@ -0,0 +1,53 @@
+#!/usr/bin/env bash
+# Measures the end-to-end startup cost of prebyte.
+#
+# Usage: scripts/bench_startup.sh [binary] [runs]
+#
+# Runs `prebyte -v`, an empty render and a one-variable render many times each
+# and prints the average wall-clock time per invocation. Uses the settings in
+# the current HOME, like a real build would. Warns when `prebyte -v` writes to
+# the log file, which only renders should open.
+
+set -euo pipefail
+
+BINARY=${1:-build/prebyte}
+RUNS=${2:-1000}
+
+if [ ! -x "$BINARY" ]; then
+        echo "prebyte binary not found: $BINARY" >&2
+        exit 1
+fi
+
+WORKDIR=$(mktemp -d)
+trap 'rm -rf "$WORKDIR"' EXIT
+
+: > "$WORKDIR/empty.txt"
+printf 'Hello %%%%name%%%%\n' > "$WORKDIR/one_variable.txt"
+
+measure() {
+        local label=$1
+        shift
+        local start end
+        start=$(date +%s%N)
+        for ((i = 0; i < RUNS; i++)); do
+                "$@" > /dev/null
+        done
+        end=$(date +%s%N)
+        printf '%-20s %8d us/run\n' "$label" $(( (end - start) / RUNS / 1000 ))
+}
+
+LOG_FILE="$HOME/.prebyte/prebyte.log"
+log_state() {
+        stat -c '%s %Y' "$LOG_FILE" 2>/dev/null || echo missing
+}
+
+before=$(log_state)
+"$BINARY" -v > /dev/null
+if [ "$(log_state)" != "$before" ]; then
+        echo "warning: prebyte -v wrote to $LOG_FILE" >&2
+fi
+
+echo "prebyte startup benchmark ($RUNS runs each)"
+measure "version" "$BINARY" -v
+measure "empty render" "$BINARY" "$WORKDIR/empty.txt"
+measure "one variable" "$BINARY" "$WORKDIR/one_variable.txt" -Dname=world
@@ -0,0 +1,66 @@
+#!/usr/bin/env bash
+# Checks that parallel rendering produces the same output as rendering on one thread.
+#
+# Usage: scripts/check_parallel.sh [binary]
+#
+# Renders a set of inputs that are large enough to be split into chunks, once
+# with parallel_threads=1 and once with parallel_threads=4, and compares the
+# outputs. Exits with a non-zero status on the first difference.
+
+set -euo pipefail
+
+BINARY=$(realpath "${1:-build/prebyte}")
+
+if [ ! -x "$BINARY" ]; then
+        echo "prebyte binary not found: $BINARY" >&2
+        exit 1
+fi
+
+WORKDIR=$(mktemp -d)
+trap 'rm -rf "$WORKDIR"' EXIT
+cd "$WORKDIR"
+
+padding() {
+        for ((i = 0; i < 20000; i++)); do
+                echo "padding line $i"
+        done
+}
+
+printf 'name\nalice\nbob\n' > d.csv
+
+# A macro called in a later chunk reads the variable a file loop left behind.
+{
+        echo '%%define macro m%%[%%row.name%%]%%enddef%%'
+        echo '%%for row in "d.csv"%%%%row.name%%%%endfor%%'
+        padding
+        echo '%%exec m%%'
+} > macro_reads_loop_variable.txt
+
+# A later chunk reads the variable a file loop left behind.
+{
+        echo '%%for row in "d.csv"%%%%row.name%%%%endfor%%'
+        padding
+        echo '%%row.name%%'
+} > chunk_reads_loop_variable.txt
+
+# Independent chunks with a top-level array loop.
+{
+        echo '%%for n in names%%%%n%%%%endfor%%'
+        padding
+        echo '%%n%%'
+        padding
+} > array_loop.txt
+
+failed=0
+for input in *.txt; do
+        expected=$("$BINARY" "$input" -Dnames=[a,b,c] -r parallel_threads=1)
+        actual=$("$BINARY" "$input" -Dnames=[a,b,c] -r parallel_threads=4)
+        if [ "$expected" == "$actual" ]; then
+                echo "ok      $input"
+        else
+                echo "FAILED  $input"
+                diff <(echo "$expected") <(echo "$actual") | head -n 10
+                failed=1
+        fi
+done
+exit $failed
@@ -23,6 +23,16 @@ void Executer::execute() {
                 case ActionType::FILE_IN_STDOUT:
                 case ActionType::STDIN_FILE_OUT:
                 case ActionType::STDIN_STDOUT: {
+                        if (context->specialize) {
+                                Specializer processor(std::move(context));
+                                processor.process();
+                                break;
+                        }
+                        if (!context->rows_source.empty()) {
+                                BatchProcessor processor(std::move(context));
+                                processor.process();
+                                break;
+                        }
                         Preprocessor preprocessor(std::move(context));
                         preprocessor.process();
                         break;
@@ -5,6 +5,9 @@
 
 #include "parser/FileParser.h"
 #include "processor/Preprocessor.h"
+#include "processor/BatchProcessor.h"
+#include "processor/IncrementalRenderer.h"
+#include "processor/Specializer.h"
 
 namespace prebyte {
 
@@ -23,6 +26,7 @@ Prebyte::Prebyte() : Prebyte("") {}
 
 Prebyte::Prebyte(std::string settings_file) {
         context = std::make_unique<prebyte::Context>();
+        context->is_api = true;
         set_logger();
         context->logger->info("Prebyte Engine initialized");
         context->rules.init();
@@ -111,8 +115,8 @@ std::map<std::string,std::vector<std::string>> get_variables(const Data& variabl
                         context->logger->trace("Variable: '{}' is a string with value: '{}'", variable_name, value.as_string());
                         variable_list[variable_name] = {value.as_string()};
                 } else if (value.is_int()) {
-                        context->logger->trace("Variable: '{}' is an integer with value: {}", variable_name, value.as_int());
-                        variable_list[variable_name] = {std::to_string(value.as_int())};
+                        context->logger->trace("Variable: '{}' is an integer with value: {}", variable_name, value.as_int64());
+                        variable_list[variable_name] = {std::to_string(value.as_int64())};
                 } else if (value.is_double()) {
                         context->logger->trace("Variable: '{}' is a double with value: {}", variable_name, value.as_double());
                         variable_list[variable_name] = {std::to_string(value.as_double())};
@@ -131,8 +135,8 @@ std::map<std::string,std::vector<std::string>> get_variables(const Data& variabl
                                         context->logger->trace("Array item for variable: '{}' is a string with value: '{}'", variable_name, item.as_string());
                                         variable_list[variable_name] = {item.as_string()};
                                 } else if (item.is_int()) {
-                                        context->logger->trace("Array item for variable: '{}' is an integer with value: {}", variable_name, item.as_int());
-                                        variable_list[variable_name] = {std::to_string(item.as_int())};
+                                        context->logger->trace("Array item for variable: '{}' is an integer with value: {}", variable_name, item.as_int64());
+                                        variable_list[variable_name] = {std::to_string(item.as_int64())};
                                 } else if (item.is_double()) {
                                         context->logger->trace("Array item for variable: '{}' is a double with value: {}", variable_name, item.as_double());
                                         variable_list[variable_name] = {std::to_string(item.as_double())};
@@ -284,35 +288,45 @@ void Prebyte::set_profile(const std::string& profile_name) {
         for (const auto& [rule_name, rule_value] : profile.get_rules()) {
                 context->console_sink->set_level(context->rules.add_rule(rule_name, Data(rule_value)));
         }
+        context->settings_revision++;
 }
 
 void Prebyte::set_ignore(const std::string& ignore_item) {
         context->logger->trace("Adding ignore item: '{}'", ignore_item);
         context->ignore.insert(ignore_item);
+        context->settings_revision++;
 }
 
 void Prebyte::set_rule(const std::string& rule_name, const std::string& rule_value) {
         context->logger->trace("Setting rule '{}' to value '{}'", rule_name, rule_value);
         context->console_sink->set_level(context->rules.add_rule(rule_name, Data(rule_value)));
+        context->settings_revision++;
+}
+
+CancellationToken Prebyte::cancellation_token() const {
+        return context->cancellation;
+}
+
+MemoryStats Prebyte::memory_stats() const {
+        return context->memory_stats;
 }
 
 std::string Prebyte::process(const std::string& input) {
         context->logger->debug("Processing input to return output");
         context->action_type = ActionType::API_IN_API_OUT;
         context->input = input;
-        Preprocessor preprocessor(std::move(context));
-        preprocessor.process();
-        return context->output;
+        context->inputs.clear();
+        run();
+        return std::move(context->output);
 }
 
 std::string Prebyte::process_file(const std::string& file_path) {
         context->logger->debug("Processing file to return output");
         context->action_type = ActionType::FILE_IN_API_OUT;
         context->logger->trace("Setting input file path: {}", file_path);
-        context->inputs.push_back(file_path);
-        Preprocessor preprocessor(std::move(context));
-        preprocessor.process();
-        return context->output;
+        context->inputs = {file_path};
+        run();
+        return std::move(context->output);
 }
 
 void Prebyte::process(const std::string& input, const std::string& output_path) {
@@ -320,9 +334,8 @@ void Prebyte::process(const std::string& input, const std::string& output_path)
         context->action_type = ActionType::API_IN_FILE_OUT;
         context->logger->trace("Setting output file path: {}", output_path);
         context->input = input;
-        context->inputs.push_back(output_path);
-        Preprocessor preprocessor(std::move(context));
-        preprocessor.process();
+        context->inputs = {output_path};
+        run();
 }
 
 void Prebyte::process_file(const std::string& file_path, const std::string& output_path) {
@@ -330,10 +343,163 @@ void Prebyte::process_file(const std::string& file_path, const std::string& outp
         context->action_type = ActionType::FILE_IN_FILE_OUT;
         context->logger->trace("Setting input file path: {}", file_path);
         context->logger->trace("Setting output file path: {}", output_path);
-        context->inputs.push_back(file_path);
-        context->inputs.push_back(output_path);
+        context->inputs = {file_path, output_path};
+        run();
+}
+
+void Prebyte::process(const std::string& input, std::ostream& out) {
+        process(input, OutputSink([&out](std::string_view chunk) {
+                out.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        }));
+}
+
+void Prebyte::process(const std::string& input, OutputSink sink) {
+        context->logger->debug("Processing input into output sink");
+        context->action_type = ActionType::API_IN_SINK_OUT;
+        context->input = input;
+        context->inputs.clear();
+        context->output_sink = std::move(sink);
+        run();
+}
+
+void Prebyte::process_into(const std::string& input, std::string& out) {
+        process(input, OutputSink([&out](std::string_view chunk) {
+                out.append(chunk);
+        }));
+}
+
+void Prebyte::process_file(const std::string& file_path, std::ostream& out) {
+        process_file(file_path, OutputSink([&out](std::string_view chunk) {
+                out.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        }));
+}
+
+void Prebyte::process_file(const std::string& file_path, OutputSink sink) {
+        context->logger->debug("Processing file into output sink");
+        context->action_type = ActionType::FILE_IN_SINK_OUT;
+        context->logger->trace("Setting input file path: {}", file_path);
+        context->inputs = {file_path};
+        context->output_sink = std::move(sink);
+        run();
+}
+
+std::size_t RenderHandle::reused_blocks() const {
+        return this->renderer ? this->renderer->get_reused_blocks() : 0;
+}
+
+std::size_t RenderHandle::rendered_blocks() const {
+        return this->renderer ? this->renderer->get_rendered_blocks() : 0;
+}
+
+RenderHandle Prebyte::prepare(const std::string& input) {
+        context->logger->debug("Preparing input for incremental renders");
+        RenderHandle handle;
+        handle.renderer = std::make_shared<IncrementalRenderer>(input);
+        return handle;
+}
+
+std::string Prebyte::render(RenderHandle& handle) {
+        if (!handle.renderer) {
+                context->logger->error("Render handle was not created by prepare().");
+                end(context.get());
+        }
+        context->logger->debug("Rendering prepared input");
+        context->action_type = ActionType::API_IN_API_OUT;
+        Context* current = context.get();
+        Preprocessor preprocessor(std::move(context));
+        std::string output;
+        try {
+                output = handle.renderer->render(preprocessor, *current);
+        } catch (...) {
+                context = preprocessor.release_context();
+                throw;
+        }
+        context = preprocessor.release_context();
+        return output;
+}
+
+std::string Prebyte::specialize(const std::string& input, const std::vector<std::string>& constants) {
+        context->logger->debug("Specializing input against {} constants", constants.size());
+        Specializer specializer(std::move(context));
+        std::string residual;
+        try {
+                residual = specializer.specialize(input, constants);
+        } catch (...) {
+                context = specializer.release_context();
+                throw;
+        }
+        context = specializer.release_context();
+        return residual;
+}
+
+std::vector<std::string> Prebyte::process_rows(const std::string& input, const std::vector<std::map<std::string, std::string>>& rows) {
+        std::vector<std::string> outputs;
+        outputs.reserve(rows.size());
+        process_rows(input, rows, OutputSink([&outputs](std::string_view output) {
+                outputs.emplace_back(output);
+        }));
+        return outputs;
+}
+
+void Prebyte::process_rows(const std::string& input, const std::vector<std::map<std::string, std::string>>& rows, OutputSink sink) {
+        context->logger->debug("Processing input for {} rows", rows.size());
+        std::vector<BatchProcessor::Row> row_variables;
+        row_variables.reserve(rows.size());
+        for (const auto& row : rows) {
+                BatchProcessor::Row variables;
+                for (const auto& [name, value] : row) {
+                        variables[name] = {value};
+                }
+                row_variables.push_back(std::move(variables));
+        }
+        run_rows(input, row_variables, [&sink](std::size_t, std::string& output) {
+                sink(output);
+        });
+}
+
+std::vector<std::string> Prebyte::process_rows_file(const std::string& input, const std::string& rows_file) {
+        context->logger->debug("Processing input for rows from file: {}", rows_file);
+        std::vector<BatchProcessor::Row> rows;
+        try {
+                FileParser file_parser;
+                rows = BatchProcessor::get_rows(file_parser.parse(expand_tilde(rows_file)));
+        } catch (const std::exception& e) {
+                context->logger->error("Error reading row source '{}': {}", rows_file, e.what());
+                end(context.get());
+        }
+        std::vector<std::string> outputs;
+        outputs.reserve(rows.size());
+        run_rows(input, rows, [&outputs](std::size_t, std::string& output) {
+                outputs.push_back(std::move(output));
+        });
+        return outputs;
+}
+
+void Prebyte::run_rows(const std::string& input, const std::vector<std::map<std::string, std::vector<std::string>>>& rows,
+                       const std::function<void(std::size_t, std::string&)>& callback) {
+        context->action_type = ActionType::API_IN_API_OUT;
+        BatchProcessor processor(std::move(context));
+        try {
+                processor.render_rows(input, rows, callback);
+        } catch (...) {
+                context = processor.release_context();
+                throw;
+        }
+        context = processor.release_context();
+}
+
+void Prebyte::run() {
+        context->output.clear();
         Preprocessor preprocessor(std::move(context));
-        preprocessor.process();
+        try {
+                preprocessor.process();
+        } catch (...) {
+                context = preprocessor.release_context();
+                context->output_sink = nullptr;
+                throw;
+        }
+        context = preprocessor.release_context();
+        context->output_sink = nullptr;
 }
 
 void Prebyte::set_logger() {
@@ -1,10 +1,63 @@
 #include "datatypes/Data.h"
 
+#include <limits>
+
 namespace prebyte {
 
+DataMap::DataMap(std::initializer_list<value_type> entries) {
+    this->entries.reserve(entries.size());
+    for (const auto& entry : entries) {
+        append(entry.first, entry.second);
+    }
+}
+
+Data& DataMap::operator[](std::string_view key) {
+    if (!sorted) sort();
+    if (entries.empty() || entries.back().first < key) {
+        return entries.emplace_back(std::string(key), Data()).second;
+    }
+    auto it = entries.begin() + (lower_bound(key) - entries.cbegin());
+    if (it != entries.end() && it->first == key) return it->second;
+    return entries.emplace(it, std::string(key), Data())->second;
+}
+
+void DataMap::append(std::string key, Data value) {
+    if (sorted && !entries.empty() && !(entries.back().first < key)) {
+        sorted = false;
+    }
+    entries.emplace_back(std::move(key), std::move(value));
+}
+
+const Data& DataMap::at(std::string_view key) const {
+    auto it = find(key);
+    if (it == end()) throw std::out_of_range("Key not found: " + std::string(key));
+    return it->second;
+}
+
+std::size_t DataMap::erase(std::string_view key) {
+    auto it = find(key);
+    if (it == end()) return 0;
+    entries.erase(it);
+    return 1;
+}
+
+void DataMap::sort() const {
+    if (sorted) return;
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const value_type& a, const value_type& b) { return a.first < b.first; });
+    auto last = entries.begin();
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+        if (std::next(it) != entries.end() && std::next(it)->first == it->first) continue;
+        if (last != it) *last = std::move(*it);
+        ++last;
+    }
+    entries.erase(last, entries.end());
+    sorted = true;
+}
+
 std::string Data::as_string() const {
     if (is_bool())   return std::get<bool>(value) ? "true" : "false";
-    if (is_int())    return std::to_string(std::get<int>(value));
+    if (is_int())    return std::to_string(std::get<std::int64_t>(value));
     if (is_double()) return std::to_string(std::get<double>(value));
     if (is_string()) return std::get<std::string>(value);
     throw std::bad_variant_access();
@@ -21,8 +74,24 @@ int Data::as_int() const {
             throw std::bad_variant_access();
         }
     }
+    std::int64_t number = as_int64();
+    if (number < std::numeric_limits<int>::min() || number > std::numeric_limits<int>::max()) throw std::bad_variant_access();
+    return static_cast<int>(number);
+}
+
+std::int64_t Data::as_int64() const {
+    if (is_string()) {
+        const auto& str = std::get<std::string>(value);
+        try {
+            return std::stoll(str);
+        } catch (const std::invalid_argument&) {
+            throw std::bad_variant_access();
+        } catch (const std::out_of_range&) {
+            throw std::bad_variant_access();
+        }
+    }
     if (!is_int()) throw std::bad_variant_access();
-    return std::get<int>(value);
+    return std::get<std::int64_t>(value);
 }
 
 double Data::as_double() const {
@@ -62,10 +131,7 @@ const Data::Array& Data::as_array() const {
 
 const Data& Data::operator[](const std::string& key) const {
     if (!is_map()) throw std::runtime_error("Not a map");
-    const auto& m = std::get<Map>(value);
-    auto it = m.find(key);
-    if (it == m.end()) throw std::out_of_range("Key not found: " + key);
-    return it->second;
+    return std::get<Map>(value).at(key);
 }
 
 Data& Data::operator[](const std::string& key) {
@@ -0,0 +1,34 @@
+#include "datatypes/Environment.h"
+
+#include <unistd.h>
+
+extern char** environ;
+
+namespace prebyte {
+
+Environment Environment::capture() {
+        Environment environment;
+        for (char** entry = environ; entry && *entry; ++entry) {
+                std::string_view pair(*entry);
+                std::size_t separator = pair.find('=');
+                if (separator == std::string_view::npos) continue;
+                // getenv returns the first entry for a duplicated name, so keep the first one too.
+                environment.values.emplace(std::string(pair.substr(0, separator)), std::string(pair.substr(separator + 1)));
+        }
+        return environment;
+}
+
+std::size_t Environment::memory_usage() const {
+        std::size_t bytes = this->values.bucket_count() * sizeof(void*);
+        for (const auto& [name, value] : this->values) {
+                bytes += sizeof(std::pair<const std::string, std::string>) + 2 * sizeof(void*) + name.capacity() + value.capacity();
+        }
+        return bytes;
+}
+
+const std::string* Environment::find(std::string_view name) const {
+        auto it = this->values.find(name);
+        return it == this->values.end() ? nullptr : &it->second;
+}
+
+}
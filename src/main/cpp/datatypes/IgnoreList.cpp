@@ -0,0 +1,124 @@
+#include "datatypes/IgnoreList.h"
+
+#include <algorithm>
+
+namespace prebyte {
+
+IgnoreList::IgnoreList(std::unordered_set<std::string> patterns) : patterns(std::move(patterns)) {}
+
+void IgnoreList::insert(const std::string& pattern) {
+        this->patterns.insert(pattern);
+        invalidate();
+}
+
+void IgnoreList::erase(const std::string& pattern) {
+        this->patterns.erase(pattern);
+        invalidate();
+}
+
+bool IgnoreList::matches(const std::string& name) const {
+        if (this->patterns.empty()) return false;
+
+        auto cached = this->results.find(name);
+        if (cached != this->results.end()) {
+                return cached->second;
+        }
+        if (!this->matcher) {
+                this->matcher = compile();
+        }
+        bool result = this->matcher->matches(name);
+        this->results.emplace(name, result);
+        return result;
+}
+
+bool IgnoreList::glob_match(std::string_view pattern, std::string_view name) {
+        // Iterative matcher: on a mismatch, let the last `*` absorb one more character.
+        std::size_t p = 0, n = 0;
+        std::size_t star = std::string_view::npos, star_n = 0;
+        while (n < name.size()) {
+                if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) {
+                        ++p;
+                        ++n;
+                } else if (p < pattern.size() && pattern[p] == '*') {
+                        star = p++;
+                        star_n = n;
+                } else if (star != std::string_view::npos) {
+                        p = star + 1;
+                        n = ++star_n;
+                } else {
+                        return false;
+                }
+        }
+        while (p < pattern.size() && pattern[p] == '*') ++p;
+        return p == pattern.size();
+}
+
+std::shared_ptr<const IgnoreList::Matcher> IgnoreList::compile() const {
+        auto compiled = std::make_shared<Matcher>();
+        for (const std::string& pattern : this->patterns) {
+                std::size_t wildcard = pattern.find_first_of("*?");
+                if (wildcard == std::string::npos) {
+                        compiled->exact.insert(pattern);
+                        continue;
+                }
+                if (wildcard == 0 && pattern[0] == '*' && pattern.find_first_of("*?", 1) == std::string::npos) {
+                        compiled->suffixes.insert(pattern.substr(1));
+                        continue;
+                }
+
+                std::size_t node = 0;
+                for (std::size_t i = 0; i < wildcard; ++i) {
+                        auto& children = compiled->trie[node].children;
+                        auto child = std::find_if(children.begin(), children.end(),
+                                                  [c = pattern[i]](const auto& entry) { return entry.first == c; });
+                        if (child != children.end()) {
+                                node = child->second;
+                        } else {
+                                std::size_t next = compiled->trie.size();
+                                compiled->trie[node].children.emplace_back(pattern[i], next);
+                                compiled->trie.emplace_back();
+                                node = next;
+                        }
+                }
+                compiled->trie[node].tails.push_back(pattern.substr(wildcard));
+        }
+
+        for (const std::string& suffix : compiled->suffixes) {
+                if (std::find(compiled->suffix_lengths.begin(), compiled->suffix_lengths.end(), suffix.size()) == compiled->suffix_lengths.end()) {
+                        compiled->suffix_lengths.push_back(suffix.size());
+                }
+        }
+        return compiled;
+}
+
+void IgnoreList::invalidate() {
+        this->matcher.reset();
+        this->results.clear();
+}
+
+bool IgnoreList::Matcher::matches(const std::string& name) const {
+        if (this->exact.contains(name)) return true;
+
+        std::string_view view = name;
+        for (std::size_t length : this->suffix_lengths) {
+                if (length <= view.size() && this->suffixes.contains(std::string(view.substr(view.size() - length)))) {
+                        return true;
+                }
+        }
+
+        std::size_t node = 0;
+        for (std::size_t depth = 0;; ++depth) {
+                for (const std::string& tail : this->trie[node].tails) {
+                        if (IgnoreList::glob_match(tail, view.substr(depth))) return true;
+                }
+                if (depth == view.size()) break;
+                const auto& children = this->trie[node].children;
+                auto child = std::find_if(children.begin(), children.end(),
+                                          [c = view[depth]](const auto& entry) { return entry.first == c; });
+                if (child == children.end()) break;
+                node = child->second;
+        }
+        return false;
+}
+
+}
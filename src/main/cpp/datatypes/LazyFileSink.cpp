@@ -0,0 +1,23 @@
+#include "datatypes/LazyFileSink.h"
+
+namespace prebyte {
+
+LazyFileSink::LazyFileSink(std::string filename) : filename(std::move(filename)) {}
+
+void LazyFileSink::sink_it_(const spdlog::details::log_msg& msg) {
+        if (!this->opened) {
+                this->file_helper.open(this->filename, false);
+                this->opened = true;
+        }
+        spdlog::memory_buf_t formatted;
+        this->formatter_->format(msg, formatted);
+        this->file_helper.write(formatted);
+}
+
+void LazyFileSink::flush_() {
+        if (this->opened) {
+                this->file_helper.flush();
+        }
+}
+
+}
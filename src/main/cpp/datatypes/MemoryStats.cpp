@@ -0,0 +1,53 @@
+#include "datatypes/MemoryStats.h"
+
+#include <algorithm>
+
+namespace prebyte {
+
+thread_local MemoryScope* MemoryScope::active = nullptr;
+bool MemoryScope::operator_new_counted = false;
+
+MemoryScope::MemoryScope(MemoryStats& stats) : stats(stats), previous(active) {
+        active = this;
+}
+
+MemoryScope::~MemoryScope() {
+        active = this->previous;
+}
+
+void MemoryScope::allocated(std::size_t bytes) noexcept {
+        MemoryScope* scope = active;
+        if (!scope) return;
+        scope->stats.allocations++;
+        scope->stats.allocated_bytes += bytes;
+        scope->current += bytes;
+        scope->stats.peak_bytes = std::max(scope->stats.peak_bytes, scope->current);
+}
+
+void MemoryScope::deallocated(std::size_t bytes) noexcept {
+        MemoryScope* scope = active;
+        if (!scope) return;
+        // Memory allocated before the scope started may be freed inside it.
+        scope->current -= std::min(scope->current, bytes);
+}
+
+void MemoryScope::set_counts_operator_new() {
+        operator_new_counted = true;
+}
+
+bool MemoryScope::counts_operator_new() {
+        return operator_new_counted;
+}
+
+void* CountingResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+        void* pointer = this->upstream->allocate(bytes, alignment);
+        if (!MemoryScope::counts_operator_new()) MemoryScope::allocated(bytes);
+        return pointer;
+}
+
+void CountingResource::do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) {
+        this->upstream->deallocate(pointer, bytes, alignment);
+        if (!MemoryScope::counts_operator_new()) MemoryScope::deallocated(bytes);
+}
+
+}
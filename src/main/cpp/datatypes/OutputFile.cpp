@@ -0,0 +1,88 @@
+#include "datatypes/OutputFile.h"
+
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+
+#include "parser/MappedFile.h"
+
+namespace prebyte {
+
+OutputFile::OutputFile(const std::filesystem::path& path, bool skip_unchanged) : target(path), skip_unchanged(skip_unchanged) {
+        std::error_code ec;
+        std::filesystem::path resolved = std::filesystem::canonical(path, ec);
+        if (!ec) {
+                this->target = resolved;
+        }
+        this->temp_path = this->target.parent_path() / ("." + this->target.filename().string() + "." + std::to_string(::getpid()) + ".tmp");
+        this->out.open(this->temp_path, std::ios::binary | std::ios::trunc);
+        if (!this->out) {
+                throw std::runtime_error("Error opening output file: " + this->target.string());
+        }
+}
+
+OutputFile::~OutputFile() {
+        if (!this->committed) {
+                this->out.close();
+                std::error_code ec;
+                std::filesystem::remove(this->temp_path, ec);
+        }
+}
+
+bool OutputFile::commit() {
+        this->out.close();
+        if (!this->out) {
+                throw std::runtime_error("Error writing output file: " + this->target.string());
+        }
+
+        std::error_code ec;
+        if (this->skip_unchanged) {
+                bool unchanged = false;
+                try {
+                        MappedFile written(this->temp_path);
+                        unchanged = has_content(this->target, written.view());
+                } catch (const std::exception&) {
+                }
+                if (unchanged) {
+                        this->committed = true;
+                        std::filesystem::remove(this->temp_path, ec);
+                        return false;
+                }
+        }
+
+        std::filesystem::file_status status = std::filesystem::status(this->target, ec);
+        if (!ec && std::filesystem::exists(status)) {
+                std::filesystem::permissions(this->temp_path, status.permissions(), ec);
+        }
+        std::filesystem::rename(this->temp_path, this->target, ec);
+        if (ec) {
+                throw std::runtime_error("Error replacing output file " + this->target.string() + ": " + ec.message());
+        }
+        this->committed = true;
+        return true;
+}
+
+bool OutputFile::write(const std::filesystem::path& path, std::string_view content, bool skip_unchanged) {
+        if (skip_unchanged && has_content(path, content)) {
+                return false;
+        }
+        OutputFile file(path, false);
+        file.stream().write(content.data(), static_cast<std::streamsize>(content.size()));
+        return file.commit();
+}
+
+bool OutputFile::has_content(const std::filesystem::path& path, std::string_view content) {
+        std::error_code ec;
+        std::uintmax_t size = std::filesystem::file_size(path, ec);
+        if (ec || size != content.size()) {
+                return false;
+        }
+        try {
+                MappedFile existing(path);
+                return existing.view() == content;
+        } catch (const std::exception&) {
+                return false;
+        }
+}
+
+}
@@ -14,6 +14,8 @@ spdlog::level::level_enum Rules::add_rule(std::string rule_name, const Data& rul
                 this->allow_env = rule_data.as_bool();
         } else if (rule_name == "allow_env_fallback") {
                 this->allow_env_fallback = rule_data.as_bool();
+        } else if (rule_name == "skip_unchanged_output") {
+                this->skip_unchanged_output = rule_data.as_bool();
         } else if (rule_name == "log_level") {
                 std::string debug_level_str = get_string(rule_data);
                 if (debug_level_str == "ERROR" || debug_level_str == "ERR") {
@@ -40,22 +42,52 @@ spdlog::level::level_enum Rules::add_rule(std::string rule_name, const Data& rul
         } else if (rule_name == "variable_suffix") {
                 this->variable_suffix = get_string(rule_data);
         } else if (rule_name == "include_path") {
-                std::string include_path_str = get_string(rule_data);
-                if (include_path_str[0] == '~') {
-                        include_path_str = getenv("HOME") + include_path_str.substr(1);
-                }
-                this->include_path = std::filesystem::path(include_path_str);
+                this->include_path = get_string(rule_data);
         } else if (rule_name == "benchmark") {
                 std::string benchmark_str = get_string(rule_data);
                 if (benchmark_str == "NONE") {
                         this->benchmark = Benchmark::NONE;
                 } else if (benchmark_str == "TIME") {
                         this->benchmark = Benchmark::TIME;
+                } else if (benchmark_str == "MEMORY") {
+                        this->benchmark = Benchmark::MEMORY;
                 } else if (benchmark_str == "ALL") {
                         this->benchmark = Benchmark::ALL;
                 } else {
                         throw std::runtime_error("Unknown benchmark type: " + benchmark_str);
                 }
+        } else if (rule_name == "batch_threads") {
+                int batch_threads = get_int(rule_data);
+                if (batch_threads < 0) {
+                        throw std::runtime_error("batch_threads must not be negative.");
+                }
+                this->batch_threads = batch_threads;
+        } else if (rule_name == "parallel_threads") {
+                int parallel_threads = get_int(rule_data);
+                if (parallel_threads < 0) {
+                        throw std::runtime_error("parallel_threads must not be negative.");
+                }
+                this->parallel_threads = parallel_threads;
+        } else if (rule_name == "macro_cache_size") {
+                int macro_cache_size = get_int(rule_data);
+                if (macro_cache_size < 0) {
+                        throw std::runtime_error("macro_cache_size must not be negative.");
+                }
+                this->macro_cache_size = macro_cache_size;
+        } else if (rule_name == "max_output_size" || rule_name == "max_loop_iterations" || rule_name == "render_timeout_ms") {
+                std::int64_t limit = get_int64(rule_data);
+                if (limit < 0) {
+                        throw std::runtime_error(rule_name + " must not be negative.");
+                }
+                if (rule_name == "max_output_size") this->max_output_size = limit;
+                else if (rule_name == "max_loop_iterations") this->max_loop_iterations = limit;
+                else this->render_timeout_ms = limit;
+        } else if (rule_name == "max_include_depth" || rule_name == "max_macro_depth") {
+                int max_depth = get_int(rule_data);
+                if (max_depth < 1) {
+                        throw std::runtime_error(rule_name + " must be at least 1.");
+                }
+                (rule_name == "max_include_depth" ? this->max_include_depth : this->max_macro_depth) = max_depth;
         } else {
                 throw std::runtime_error("Unknown rule: " + rule_name);
         }
@@ -71,10 +103,19 @@ std::string Rules::get_string(Data data) {
 }
 
 int Rules::get_int(Data data) {
-        if (!data.is_int()) {
+        try {
+                return data.as_int();
+        } catch (const std::bad_variant_access&) {
+                throw std::runtime_error("Expected integer value.");
+        }
+}
+
+std::int64_t Rules::get_int64(Data data) {
+        try {
+                return data.as_int64();
+        } catch (const std::bad_variant_access&) {
                 throw std::runtime_error("Expected integer value.");
         }
-        return data.as_int();
 }
 
 double Rules::get_double(Data data) {
@@ -96,8 +137,36 @@ void Rules::init() {
         this->default_variable_value = "???";
         this->variable_prefix = "%%";
         this->variable_suffix = "%%";
-        this->add_rule("include_path", Data(this->include_path.value_or("~/.prebyte/includes")));
+        this->include_path = this->include_path.value_or("~/.prebyte/includes");
         this->benchmark = Benchmark::NONE;
+        this->batch_threads = 1;
+        this->parallel_threads = 1;
+        this->max_output_size = 0;
+        this->max_loop_iterations = 0;
+        this->max_include_depth = 1024;
+        this->max_macro_depth = 1024;
+        this->render_timeout_ms = 0;
+        this->skip_unchanged_output = false;
+        this->macro_cache_size = 1024;
+}
+
+std::vector<std::filesystem::path> Rules::get_include_dirs() const {
+        std::vector<std::filesystem::path> directories;
+        const std::string include_paths = this->include_path.value_or("");
+        std::string_view paths = include_paths;
+        const char* home = nullptr;
+        while (!paths.empty()) {
+                std::size_t separator = paths.find(':');
+                std::string path(paths.substr(0, separator));
+                paths.remove_prefix(separator == std::string_view::npos ? paths.size() : separator + 1);
+                if (path.empty()) continue;
+                if (path.starts_with("~")) {
+                        if (!home) home = getenv("HOME");
+                        if (home) path = home + path.substr(1);
+                }
+                directories.emplace_back(std::move(path));
+        }
+        return directories;
 }
 
 }
@@ -1,16 +1,51 @@
+#include <cstdlib>
 #include <list>
+#include <new>
 #include <string>
 #include "parser/CliParser.h"
 #include "datatypes/CliStruct.h"
 #include "datatypes/Context.h"
 #include "processor/ContextProcessor.h"
 #include "Executer.h"
+#include "datatypes/MemoryStats.h"
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+
+// The CLI reports every allocation to the active MemoryScope, so benchmark=MEMORY
+// covers all memory of a render, including parsers and Data. malloc_usable_size
+// yields the same size on allocation and release, so no size header is needed;
+// it is only asked for while a scope is counting.
+void* operator new(std::size_t size) {
+        void* pointer = std::malloc(size == 0 ? 1 : size);
+        if (!pointer) throw std::bad_alloc();
+        if (prebyte::MemoryScope::is_active()) {
+                prebyte::MemoryScope::allocated(malloc_usable_size(pointer));
+        }
+        return pointer;
+}
+
+void operator delete(void* pointer) noexcept {
+        if (!pointer) return;
+        if (prebyte::MemoryScope::is_active()) {
+                prebyte::MemoryScope::deallocated(malloc_usable_size(pointer));
+        }
+        std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+        operator delete(pointer);
+}
+#endif
 
 
 const std::string VERSION = "v0.1.0";
 
 
 int main(int argc, char** argv) {
+#if defined(__GLIBC__)
+        prebyte::MemoryScope::set_counts_operator_new();
+#endif
         try {
                 std::list<std::string> args;
                 for(int i = 1; i < argc; ++i) {
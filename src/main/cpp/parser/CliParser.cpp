@@ -62,7 +62,9 @@ ActionType CliParser::findAction(std::list<std::string>* args) {
 
         if(args->front().starts_with("-D") || args->front() == "-r" || args->front() == "--rule" ||
            args->front() == "-i" || args->front() == "--ignore" || args->front() == "-p" || args->front() == "--profile" ||
-           args->front().starts_with("-P") || args->front() == "-s" || args->front() == "--settings") {
+           args->front().starts_with("-P") || args->front() == "-s" || args->front() == "--settings" ||
+           args->front() == "--rows" || args->front() == "--rows-output" ||
+           args->front() == "--specialize" || args->front() == "--constant") {
                 return ActionType::STDIN_STDOUT;
         }
 
@@ -108,6 +110,26 @@ void CliParser::process(const std::vector<std::string>& args) {
                 } else if(arg.starts_with("-D")) {
                         if(arg == "-D") throw std::runtime_error("Missing variable definition after -D");
                         this->cli_struct.variables.push_back(arg.substr(2));
+                } else if(arg == "--rows") {
+                        if(static_cast<std::size_t>(i) + 1 < args.size()) {
+                                this->cli_struct.rows_file = args[++i];
+                        } else {
+                                throw std::runtime_error("Missing row source after " + arg);
+                        }
+                } else if(arg == "--rows-output") {
+                        if(static_cast<std::size_t>(i) + 1 < args.size()) {
+                                this->cli_struct.rows_output = args[++i];
+                        } else {
+                                throw std::runtime_error("Missing output pattern after " + arg);
+                        }
+                } else if(arg == "--specialize") {
+                        this->cli_struct.specialize = true;
+                } else if(arg == "--constant") {
+                        if(static_cast<std::size_t>(i) + 1 < args.size()) {
+                                this->cli_struct.constants.push_back(args[++i]);
+                        } else {
+                                throw std::runtime_error("Missing variable name after " + arg);
+                        }
                 } else if (arg == "--trace") {
                         this->cli_struct.log_level = "TRACE";
                 } else if (arg == "--debug" || arg == "-X") {
@@ -1,158 +1,73 @@
 #include "parser/CsvParser.h"
 
-#ifdef _WIN32
-
-
-#endif
-
 namespace prebyte {
 
 Data CsvParser::parse(const std::filesystem::path& filepath) {
-    std::ifstream file(filepath);
-    if (!file.is_open()) {
-        throw std::runtime_error("Could not open file: " + filepath.string());
-    }
-
-    std::string line;
-    std::vector<std::string> headers;
-
-    Data result = Data::Array{};
-
-    if (std::getline(file, line)) {
-        std::stringstream ss(line);
-        std::string cell;
-        while (std::getline(ss, cell, ',')) {
-            headers.push_back(cell);
-        }
-        if (headers.empty()) {
-            throw std::runtime_error("No headers found in first line of CSV file");
-        }
-    } else {
-        throw std::runtime_error("CSV file is empty");
-    }
-
-    while (std::getline(file, line)) {
-        if (line.empty()) continue;
-
-        std::stringstream ss(line);
-        std::string cell;
-        size_t index = 0;
-
-        Data row = Data::Map{};
-
-        while (std::getline(ss, cell, ',')) {
-            if (index >= headers.size()) break;
-
-            const std::string& key = headers[index];
-
-            if (cell == "true" || cell == "false") {
-                row[key] = (cell == "true");
-            } else if (cell.find('.') != std::string::npos) {
-                try {
-                    row[key] = std::stod(cell);
-                } catch (...) {
-                    row[key] = cell;
-                }
-            } else {
-                try {
-                    row[key] = std::stoi(cell);
-                } catch (...) {
-                    row[key] = cell;
-                }
-            }
-
-            ++index;
-        }
-
-        Data::Array arr = result.as_array();
-        arr.push_back(row);
-    }
-
-    return result;
+    CsvReader reader(filepath);
+    return read_rows(reader, "CSV file");
 }
 
 bool CsvParser::can_parse(const std::filesystem::path& filepath) const {
     if (filepath.extension() != ".csv") return false;
 
-    std::ifstream file(filepath);
-    if (!file.is_open()) return false;
-
-    std::string line;
-    if (!std::getline(file, line) || line.empty()) return false;
-
-    size_t expected_columns = std::count(line.begin(), line.end(), ',') + 1;
-    if (expected_columns == 0) return false;
-
-    while (std::getline(file, line)) {
-        if (line.empty()) continue;
-
-        size_t columns = std::count(line.begin(), line.end(), ',') + 1;
-        if (columns != expected_columns) {
-            return false;
-        }
+    try {
+        CsvReader reader(filepath);
+        std::vector<std::string> headers;
+        return reader.next(headers);
+    } catch (...) {
+        return false;
     }
-
-    return true;
 }
 
 Data CsvParser::parse_string(const std::string& input) {
-    std::istringstream stream(input);
-    std::string line;
-    std::vector<std::string> headers;
+    CsvReader reader{std::string_view(input)};
+    return read_rows(reader, "CSV string");
+}
 
-    Data result = Data::Array{};
+Data CsvParser::read_rows(CsvReader& reader, const std::string& source) {
+    std::vector<std::string> headers;
+    if (!reader.next(headers)) {
+        throw std::runtime_error(source + " is empty");
+    }
 
-    if (std::getline(stream, line)) {
-        std::stringstream ss(line);
-        std::string cell;
-        while (std::getline(ss, cell, ',')) {
-            headers.push_back(cell);
+    Data::Array rows;
+    std::vector<std::string> fields;
+    while (reader.next(fields)) {
+        if (fields.size() != headers.size()) {
+            throw std::runtime_error("CSV record " + std::to_string(reader.get_record_count()) + " has " +
+                                     std::to_string(fields.size()) + " columns, expected " + std::to_string(headers.size()));
         }
-        if (headers.empty()) {
-            throw std::runtime_error("No headers found in first line of CSV string");
+
+        Data::Map row;
+        row.reserve(headers.size());
+        for (std::size_t i = 0; i < headers.size(); ++i) {
+            row.append(headers[i], convert_field(fields[i]));
         }
-    } else {
-        throw std::runtime_error("CSV string is empty");
+        rows.push_back(Data(std::move(row)));
     }
 
-    while (std::getline(stream, line)) {
-        if (line.empty()) continue;
-
-        std::stringstream ss(line);
-        std::string cell;
-        size_t index = 0;
-
-        Data row = Data::Map{};
-
-        while (std::getline(ss, cell, ',')) {
-            if (index >= headers.size()) break;
-
-            const std::string& key = headers[index];
-
-            if (cell == "true" || cell == "false") {
-                row[key] = (cell == "true");
-            } else if (cell.find('.') != std::string::npos) {
-                try {
-                    row[key] = std::stod(cell);
-                } catch (...) {
-                    row[key] = cell;
-                }
-            } else {
-                try {
-                    row[key] = std::stoi(cell);
-                } catch (...) {
-                    row[key] = cell;
-                }
-            }
-
-            ++index;
-        }
+    return Data(std::move(rows));
+}
 
-        Data::Array arr = result.as_array();
-        arr.push_back(row);
+Data CsvParser::convert_field(const std::string& field) {
+    if (field == "true" || field == "false") {
+        return Data(field == "true");
     }
-
-    return result;
+    if (field.empty()) {
+        return Data(field);
+    }
+    const char* begin = field.data();
+    const char* end = field.data() + field.size();
+    if (field.find('.') != std::string::npos) {
+        double number;
+        auto [ptr, ec] = std::from_chars(begin, end, number);
+        if (ec == std::errc() && ptr == end) return Data(number);
+    } else {
+        std::int64_t number;
+        auto [ptr, ec] = std::from_chars(begin, end, number);
+        if (ec == std::errc() && ptr == end) return Data(number);
+    }
+    return Data(field);
 }
 
 } // namespace prebyte
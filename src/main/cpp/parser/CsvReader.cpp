@@ -0,0 +1,117 @@
+#include "parser/CsvReader.h"
+
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace prebyte {
+
+namespace {
+
+inline bool is_special(char c) {
+    return c == ',' || c == '"' || c == '\n' || c == '\r';
+}
+
+}
+
+CsvReader::CsvReader(const std::filesystem::path& filepath) : file(filepath) {
+    this->input = this->file.view();
+}
+
+CsvReader::CsvReader(std::string_view input) : input(input) {}
+
+bool CsvReader::next(std::vector<std::string>& fields) {
+    while (position < input.size() && (input[position] == '\n' || input[position] == '\r')) {
+        ++position;
+    }
+    if (position >= input.size()) return false;
+
+    std::size_t count = 0;
+    while (true) {
+        if (count == fields.size()) fields.emplace_back();
+        std::string& field = fields[count++];
+        field.clear();
+
+        if (position < input.size() && input[position] == '"') {
+            read_quoted(field);
+        }
+        read_plain(field);
+
+        if (position >= input.size()) break;
+        if (input[position] == ',') {
+            ++position;
+            if (position >= input.size()) {
+                if (count == fields.size()) fields.emplace_back();
+                fields[count++].clear();
+                break;
+            }
+            continue;
+        }
+        if (input[position] == '\r') ++position;
+        if (position < input.size() && input[position] == '\n') ++position;
+        break;
+    }
+
+    fields.resize(count);
+    ++record_count;
+    return true;
+}
+
+void CsvReader::read_plain(std::string& field) {
+    std::size_t start = position;
+    std::size_t end = find_special(position);
+    while (end < input.size() && input[end] == '"') {
+        end = find_special(end + 1);
+    }
+    field.append(input.data() + start, end - start);
+    position = end;
+}
+
+void CsvReader::read_quoted(std::string& field) {
+    ++position;
+    while (true) {
+        const void* quote = std::memchr(input.data() + position, '"', input.size() - position);
+        if (!quote) {
+            throw std::runtime_error("Unterminated quoted field in CSV record " + std::to_string(record_count + 1));
+        }
+        std::size_t end = static_cast<const char*>(quote) - input.data();
+        field.append(input.data() + position, end - position);
+        position = end + 1;
+        if (position < input.size() && input[position] == '"') {
+            field += '"';
+            ++position;
+            continue;
+        }
+        return;
+    }
+}
+
+std::size_t CsvReader::find_special(std::size_t position) const {
+    const char* data = input.data();
+    const std::size_t size = input.size();
+#if defined(__SSE2__)
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i line_feed = _mm_set1_epi8('\n');
+    const __m128i carriage_return = _mm_set1_epi8('\r');
+    while (position + 16 <= size) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + position));
+        __m128i matches = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, comma), _mm_cmpeq_epi8(chunk, quote)),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, line_feed), _mm_cmpeq_epi8(chunk, carriage_return)));
+        int mask = _mm_movemask_epi8(matches);
+        if (mask != 0) {
+            return position + static_cast<std::size_t>(__builtin_ctz(static_cast<unsigned int>(mask)));
+        }
+        position += 16;
+    }
+#endif
+    while (position < size && !is_special(data[position])) {
+        ++position;
+    }
+    return position;
+}
+
+}
@@ -31,7 +31,7 @@ Data EnvParser::parse(const std::filesystem::path& filepath) {
         value.erase(0, value.find_first_not_of(" \t"));
         value.erase(value.find_last_not_of(" \t") + 1);
 
-        env_data[key] = value;
+        env_data.append(std::move(key), std::move(value));
     }
 
     return env_data;
@@ -83,7 +83,7 @@ Data EnvParser::parse_string(const std::string& input) {
         value.erase(0, value.find_first_not_of(" \t"));
         value.erase(value.find_last_not_of(" \t") + 1);
 
-        env_data[key] = value;
+        env_data.append(std::move(key), std::move(value));
     }
 
     return env_data;
@@ -3,8 +3,6 @@
 namespace prebyte {
 
 Data FileParser::parse(const std::string& filePath) {
-    Parser* parser;
-
     if (filePath.empty()) {
         throw std::runtime_error("File path cannot be empty");
     }
@@ -13,37 +11,94 @@ Data FileParser::parse(const std::string& filePath) {
         throw std::runtime_error("File does not exist or is not a regular file: " + filePath);
     }
 
-    if (filePath.ends_with(".json")) {
-        parser = new JsonParser();
-    } else if (filePath.ends_with(".xml")) {
-        parser = new XmlParser();
-    } else if (filePath.ends_with(".yaml") || filePath.ends_with(".yml")) {
-        parser = new YamlParser();
-    } else if (filePath.ends_with(".csv")) {
-        parser = new CsvParser();
-    } else if (filePath.ends_with(".ini") || filePath.ends_with(".cfg")) {
-        parser = new IniParser();
-    } else if (filePath.ends_with(".env")) {
-        parser = new EnvParser();
-    } else if (filePath.ends_with(".toml")) {
-        parser = new TomlParser();
-    } else {
+    std::optional<ParserType> type = detect_type(filePath);
+    if (!type) {
         throw std::runtime_error("Unsupported file format: " + filePath);
     }
-    return parseFile(filePath, parser);
+    return parseFile(filePath, get_parser(*type));
 }
 
-Data FileParser::parseFile(const std::string& filePath, Parser* parser) {
-        if (!parser->can_parse(filePath)) {
-            throw std::runtime_error("Cannot parse file with the selected parser: " + filePath);
+Parser& FileParser::get_parser(ParserType parserType) {
+    switch (parserType) {
+        case ParserType::JSON: {
+            static JsonParser parser;
+            return parser;
+        }
+        case ParserType::XML: {
+            static XmlParser parser;
+            return parser;
+        }
+        case ParserType::YAML: {
+            static YamlParser parser;
+            return parser;
+        }
+        case ParserType::CSV: {
+            static CsvParser parser;
+            return parser;
+        }
+        case ParserType::INI: {
+            static IniParser parser;
+            return parser;
+        }
+        case ParserType::ENV: {
+            static EnvParser parser;
+            return parser;
         }
+        case ParserType::TOML: {
+            static TomlParser parser;
+            return parser;
+        }
+    }
+    throw std::runtime_error("Unsupported parser type");
+}
+
+std::optional<ParserType> FileParser::detect_type(const std::filesystem::path& filePath) {
+    const std::string extension = filePath.extension().string();
+    const std::string filename = filePath.filename().string();
+
+    if (extension == ".json") return ParserType::JSON;
+    if (extension == ".xml") return ParserType::XML;
+    if (extension == ".yaml" || extension == ".yml") return ParserType::YAML;
+    if (extension == ".csv") return ParserType::CSV;
+    if (extension == ".ini" || extension == ".cfg") return ParserType::INI;
+    if (extension == ".env" || filename == ".env") return ParserType::ENV;
+    if (extension == ".toml") return ParserType::TOML;
+
+    return sniff_type(filePath);
+}
+
+std::optional<ParserType> FileParser::sniff_type(const std::filesystem::path& filePath) {
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open()) return std::nullopt;
+
+    char buffer[512];
+    file.read(buffer, sizeof(buffer));
+    std::string_view head(buffer, static_cast<std::size_t>(file.gcount()));
+
+    if (head.starts_with("\xEF\xBB\xBF")) head.remove_prefix(3);
+    std::size_t start = head.find_first_not_of(" \t\r\n");
+    if (start == std::string_view::npos) return std::nullopt;
+    head.remove_prefix(start);
+
+    if (head.starts_with("<")) return ParserType::XML;
+    if (head.starts_with("{")) return ParserType::JSON;
+    if (head.starts_with("---") || head.starts_with("%YAML")) return ParserType::YAML;
+    if (head.starts_with("[")) {
+        std::size_t next = head.find_first_not_of(" \t\r\n", 1);
+        if (next == std::string_view::npos) return std::nullopt;
+        char c = head[next];
+        if (c == '{' || c == '[' || c == '"' || c == ']' || c == '-' || (c >= '0' && c <= '9')) return ParserType::JSON;
+        return ParserType::TOML;
+    }
+    return std::nullopt;
+}
+
+Data FileParser::parseFile(const std::string& filePath, Parser& parser) {
         try {
-            return parser->parse(std::filesystem::path(filePath));
+            return parser.parse(std::filesystem::path(filePath));
         } catch (const std::exception& e) {
             throw std::runtime_error("Error parsing file: " + std::string(e.what()));
         }
-
-        return Data();
 }
 
 }
@@ -1,50 +1,135 @@
 #include "parser/JsonParser.h"
 
+#include <limits>
 
 namespace prebyte {
 
-Data convert_json(const nlohmann::json& j) {
-    if (j.is_null()) {
-        return Data();
-    } else if (j.is_boolean()) {
-        return Data(j.get<bool>());
-    } else if (j.is_number_integer()) {
-        return Data(j.get<int>());
-    } else if (j.is_number_float()) {
-        return Data(j.get<double>());
-    } else if (j.is_string()) {
-        return Data(j.get<std::string>());
-    } else if (j.is_array()) {
-        Data::Array arr;
-        for (const auto& elem : j) {
-            arr.push_back(convert_json(elem));
+namespace {
+
+/**
+ * SAX handler that builds `Data` directly while nlohmann parses the input,
+ * so no intermediate `nlohmann::json` tree is created. With a callback, the
+ * elements of a top-level array are handed over one by one instead of being
+ * collected.
+ */
+class DataBuilder {
+public:
+    using number_integer_t  = nlohmann::json::number_integer_t;
+    using number_unsigned_t = nlohmann::json::number_unsigned_t;
+    using number_float_t    = nlohmann::json::number_float_t;
+    using string_t          = nlohmann::json::string_t;
+    using binary_t          = nlohmann::json::binary_t;
+
+    explicit DataBuilder(const JsonParser::ElementCallback* callback = nullptr) : callback(callback) {}
+
+    bool null() { return add(Data()); }
+    bool boolean(bool value) { return add(Data(value)); }
+    bool number_integer(number_integer_t value) { return add(Data(static_cast<std::int64_t>(value))); }
+    bool number_unsigned(number_unsigned_t value) {
+        if (value > static_cast<number_unsigned_t>(std::numeric_limits<std::int64_t>::max())) return add(Data(static_cast<double>(value)));
+        return add(Data(static_cast<std::int64_t>(value)));
+    }
+    bool number_float(number_float_t value, const string_t&) { return add(Data(value)); }
+    bool string(string_t& value) { return add(Data(std::move(value))); }
+    bool binary(binary_t&) { return add(Data()); }
+
+    bool start_object(std::size_t) {
+        frames.push_back(Frame{true});
+        return true;
+    }
+
+    bool key(string_t& key) {
+        frames.back().key = std::move(key);
+        return true;
+    }
+
+    bool end_object() {
+        Data::Map map = std::move(frames.back().map);
+        frames.pop_back();
+        return add(Data(std::move(map)));
+    }
+
+    bool start_array(std::size_t) {
+        if (frames.empty() && callback) streamed = true;
+        frames.push_back(Frame{false});
+        return true;
+    }
+
+    bool end_array() {
+        Data::Array array = std::move(frames.back().array);
+        frames.pop_back();
+        return add(Data(std::move(array)));
+    }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::json::exception& e) {
+        error = e.what();
+        return false;
+    }
+
+    /** @brief Returns the parsed value; empty if the top-level array was streamed. */
+    Data& get_result() { return result; }
+
+    /** @brief Returns the message of the parse error that stopped parsing; empty if there was none. */
+    const std::string& get_error() const { return error; }
+
+    /** @brief Returns true if the top-level value was an array handed to the callback. */
+    bool was_streamed() const { return streamed; }
+
+private:
+    struct Frame {
+        bool is_object = false;
+        Data::Map map{};
+        Data::Array array{};
+        std::string key{};
+    };
+
+    std::vector<Frame> frames;
+    Data result;
+    const JsonParser::ElementCallback* callback;
+    bool streamed = false;
+    std::string error;
+
+    bool add(Data value) {
+        if (frames.empty()) {
+            result = std::move(value);
+            return true;
+        }
+        Frame& top = frames.back();
+        if (streamed && frames.size() == 1) {
+            return (*callback)(value);
         }
-        return Data(std::move(arr));
-    } else if (j.is_object()) {
-        Data::Map map;
-        for (const auto& [key, value] : j.items()) {
-            map[key] = convert_json(value);
+        if (top.is_object) {
+            top.map.append(std::move(top.key), std::move(value));
+        } else {
+            top.array.push_back(std::move(value));
         }
-        return Data(std::move(map));
+        return true;
     }
+};
+
+Data parse_view(std::string_view input) {
+    DataBuilder builder;
+    if (!nlohmann::json::sax_parse(input.begin(), input.end(), &builder)) {
+        throw std::runtime_error(builder.get_error());
+    }
+    return std::move(builder.get_result());
+}
 
-    throw std::runtime_error("Unknown JSON type");
 }
 
 Data JsonParser::parse(const std::filesystem::path& filepath) {
-    std::ifstream file(filepath);
-    if (!file.is_open()) {
+    MappedFile file;
+    try {
+        file = MappedFile(filepath);
+    } catch (const std::exception&) {
         throw std::runtime_error("Could not open JSON file: " + filepath.string());
     }
 
-    nlohmann::json j;
     try {
-        file >> j;
+        return parse_view(file.view());
     } catch (const std::exception& e) {
         throw std::runtime_error("Failed to parse JSON: " + std::string(e.what()));
     }
-
-    return convert_json(j);
 }
 
 bool JsonParser::can_parse(const std::filesystem::path& filepath) const {
@@ -53,24 +138,57 @@ bool JsonParser::can_parse(const std::filesystem::path& filepath) const {
     std::ifstream file(filepath);
     if (!file.is_open()) return false;
 
-    try {
-            nlohmann::json j = nlohmann::json::parse(file, nullptr, true, true);  // allow exceptions
-    } catch (...) {
-        return false;
+    char c;
+    while (file.get(c)) {
+        if (c == ' ' || c == '\t' || c == '\r' || c == '\n') continue;
+        return c == '{' || c == '[' || c == '"' || c == '-' || (c >= '0' && c <= '9') || c == 't' || c == 'f' || c == 'n';
     }
-
-    return true;
+    return false;
 }
 
 Data JsonParser::parse_string(const std::string& input) {
-    nlohmann::json j;
     try {
-        j = nlohmann::json::parse(input);
+        return parse_view(input);
     } catch (const std::exception& e) {
         throw std::runtime_error("Failed to parse JSON string: " + std::string(e.what()));
     }
+}
+
+void JsonParser::for_each_element(const std::filesystem::path& filepath, const ElementCallback& callback) {
+    MappedFile file(filepath);
+    std::string_view input = file.view();
+
+    if (filepath.extension() == ".jsonl" || filepath.extension() == ".ndjson") {
+        std::size_t line_number = 0;
+        while (!input.empty()) {
+            std::size_t line_end = input.find('\n');
+            std::string_view line = input.substr(0, line_end);
+            input.remove_prefix(line_end == std::string_view::npos ? input.size() : line_end + 1);
+            ++line_number;
+
+            if (line.find_first_not_of(" \t\r") == std::string_view::npos) continue;
+            Data element;
+            try {
+                element = parse_view(line);
+            } catch (const std::exception& e) {
+                throw std::runtime_error("Failed to parse JSON in line " + std::to_string(line_number) + ": " + e.what());
+            }
+            if (!callback(element)) return;
+        }
+        return;
+    }
 
-    return convert_json(j);
+    DataBuilder builder(&callback);
+    if (!nlohmann::json::sax_parse(input.begin(), input.end(), &builder)) {
+        // The callback stops parsing by returning false; only a parse error is reported.
+        if (!builder.get_error().empty()) {
+            throw std::runtime_error("Failed to parse JSON: " + builder.get_error());
+        }
+        return;
+    }
+    if (!builder.was_streamed()) {
+        callback(builder.get_result());
+    }
 }
 
 } // namespace prebyte
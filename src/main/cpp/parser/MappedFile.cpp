@@ -0,0 +1,79 @@
+#include "parser/MappedFile.h"
+
+#include <fstream>
+#include <iterator>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace prebyte {
+
+MappedFile::MappedFile(const std::filesystem::path& filepath) {
+#ifndef _WIN32
+    int fd = ::open(filepath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Could not open file: " + filepath.string());
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Could not read file size: " + filepath.string());
+    }
+    size = static_cast<std::size_t>(info.st_size);
+    if (size > 0) {
+        void* address = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address != MAP_FAILED) {
+            ::madvise(address, size, MADV_SEQUENTIAL);
+            data = static_cast<const char*>(address);
+            mapped = true;
+        }
+    }
+    ::close(fd);
+    if (mapped || size == 0) return;
+#endif
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file: " + filepath.string());
+    }
+    buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    data = buffer.data();
+    size = buffer.size();
+}
+
+MappedFile::~MappedFile() {
+    release();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this == &other) return *this;
+    release();
+    mapped = other.mapped;
+    size = other.size;
+    buffer = std::move(other.buffer);
+    data = mapped ? other.data : buffer.data();
+    other.data = nullptr;
+    other.size = 0;
+    other.mapped = false;
+    return *this;
+}
+
+void MappedFile::release() {
+#ifndef _WIN32
+    if (mapped) {
+        ::munmap(const_cast<char*>(data), size);
+    }
+#endif
+    data = nullptr;
+    size = 0;
+    mapped = false;
+}
+
+}
@@ -0,0 +1,279 @@
+#include "parser/SettingsSnapshot.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+#include <string_view>
+#include <unistd.h>
+
+#include "parser/ContentHash.h"
+#include "parser/MappedFile.h"
+
+namespace prebyte {
+
+namespace {
+
+/// Identifies the file format. Bump the version whenever the layout changes.
+constexpr std::string_view SNAPSHOT_MAGIC = "PBSNAP02";
+
+/**
+ * Stamps are stored in native byte order; a snapshot is a local cache and
+ * never shared between machines.
+ */
+using SourceStamp = SettingsSnapshot::SourceStamp;
+
+/// Canonical form of a settings path, which names and identifies its snapshot.
+std::string canonical_source(const std::filesystem::path& source) {
+    std::error_code error;
+    std::filesystem::path canonical = std::filesystem::weakly_canonical(source, error);
+    if (error) canonical = std::filesystem::absolute(source, error);
+    if (error) canonical = source;
+    return canonical.string();
+}
+
+std::uint64_t hash_file(const std::filesystem::path& source) {
+    MappedFile file(source);
+    return hash_content(file.view());
+}
+
+class SnapshotWriter {
+public:
+    template <typename T>
+    void put(T value) {
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void put_string(std::string_view value) {
+        put(static_cast<std::uint32_t>(value.size()));
+        buffer.append(value);
+    }
+
+    void put_variables(const std::map<std::string, std::vector<std::string>>& variables) {
+        put(static_cast<std::uint32_t>(variables.size()));
+        for (const auto& [name, values] : variables) {
+            put_string(name);
+            put(static_cast<std::uint32_t>(values.size()));
+            for (const auto& value : values) put_string(value);
+        }
+    }
+
+    void put_ignore(const std::unordered_set<std::string>& ignore) {
+        put(static_cast<std::uint32_t>(ignore.size()));
+        for (const auto& item : ignore) put_string(item);
+    }
+
+    void put_rules(const std::map<std::string, std::string>& rules) {
+        put(static_cast<std::uint32_t>(rules.size()));
+        for (const auto& [name, value] : rules) {
+            put_string(name);
+            put_string(value);
+        }
+    }
+
+    const std::string& data() const { return buffer; }
+
+private:
+    std::string buffer;
+};
+
+class SnapshotReader {
+public:
+    explicit SnapshotReader(std::string_view input) : input(input) {}
+
+    template <typename T>
+    T get() {
+        T value;
+        std::memcpy(&value, take(sizeof(T)).data(), sizeof(T));
+        return value;
+    }
+
+    /// Reads an element count. Every element takes at least four bytes, which bounds damaged counts.
+    std::uint32_t get_count() {
+        std::uint32_t count = get<std::uint32_t>();
+        if (count > input.size() / sizeof(std::uint32_t)) {
+            throw std::runtime_error("Settings snapshot is damaged");
+        }
+        return count;
+    }
+
+    std::string get_string() {
+        std::uint32_t size = get<std::uint32_t>();
+        return std::string(take(size));
+    }
+
+    std::map<std::string, std::vector<std::string>> get_variables() {
+        std::map<std::string, std::vector<std::string>> variables;
+        std::uint32_t count = get_count();
+        for (std::uint32_t i = 0; i < count; ++i) {
+            std::string name = get_string();
+            std::vector<std::string> values(get_count());
+            for (auto& value : values) value = get_string();
+            variables.emplace_hint(variables.end(), std::move(name), std::move(values));
+        }
+        return variables;
+    }
+
+    std::unordered_set<std::string> get_ignore() {
+        std::unordered_set<std::string> ignore;
+        std::uint32_t count = get_count();
+        ignore.reserve(count);
+        for (std::uint32_t i = 0; i < count; ++i) ignore.insert(get_string());
+        return ignore;
+    }
+
+    std::map<std::string, std::string> get_rules() {
+        std::map<std::string, std::string> rules;
+        std::uint32_t count = get_count();
+        for (std::uint32_t i = 0; i < count; ++i) {
+            std::string name = get_string();
+            rules.emplace_hint(rules.end(), std::move(name), get_string());
+        }
+        return rules;
+    }
+
+    bool at_end() const { return input.empty(); }
+
+private:
+    std::string_view input;
+
+    std::string_view take(std::size_t size) {
+        if (size > input.size()) {
+            throw std::runtime_error("Settings snapshot is truncated");
+        }
+        std::string_view result = input.substr(0, size);
+        input.remove_prefix(size);
+        return result;
+    }
+};
+
+SourceStamp stamp_of(const std::filesystem::path& source) {
+    SourceStamp stamp;
+    stamp.size = std::filesystem::file_size(source);
+    stamp.mtime = std::filesystem::last_write_time(source).time_since_epoch().count();
+    return stamp;
+}
+
+} // namespace
+
+std::filesystem::path SettingsSnapshot::path_for(const std::filesystem::path& source) {
+    const char* home = std::getenv("HOME");
+    if (!home) return {};
+    return std::filesystem::path(home) / ".prebyte" / "cache" /
+           std::format("settings-{:016x}.snapshot", hash_content(canonical_source(source)));
+}
+
+SettingsSnapshot::SourceStamp SettingsSnapshot::stamp(const std::filesystem::path& source) {
+    SourceStamp stamp = stamp_of(source);
+    stamp.hash = hash_file(source);
+    return stamp;
+}
+
+std::optional<SettingsSnapshot> SettingsSnapshot::load(const std::filesystem::path& source) {
+    std::filesystem::path snapshot_path = path_for(source);
+    std::error_code error;
+    if (snapshot_path.empty() || !std::filesystem::exists(snapshot_path, error)) return std::nullopt;
+
+    try {
+        MappedFile file(snapshot_path);
+        SnapshotReader reader(file.view());
+        for (char c : SNAPSHOT_MAGIC) {
+            if (reader.get<char>() != c) return std::nullopt;
+        }
+        // Different paths may hash to the same snapshot name.
+        if (reader.get_string() != canonical_source(source)) return std::nullopt;
+
+        SourceStamp recorded;
+        recorded.size = reader.get<std::uint64_t>();
+        recorded.mtime = reader.get<std::int64_t>();
+        recorded.hash = reader.get<std::uint64_t>();
+
+        SourceStamp current = stamp_of(source);
+        if (current.size != recorded.size) return std::nullopt;
+        bool touched = current.mtime != recorded.mtime;
+        if (touched) {
+            current.hash = hash_file(source);
+            if (current.hash != recorded.hash) return std::nullopt;
+        }
+
+        SettingsSnapshot snapshot;
+        snapshot.variables = reader.get_variables();
+        std::uint32_t profile_count = reader.get_count();
+        for (std::uint32_t i = 0; i < profile_count; ++i) {
+            std::string name = reader.get_string();
+            Profile profile(name);
+            profile.add_variable(reader.get_variables());
+            profile.add_ignore(reader.get_ignore());
+            profile.add_rules(reader.get_rules());
+            snapshot.profiles.emplace_hint(snapshot.profiles.end(), std::move(name), std::move(profile));
+        }
+        snapshot.ignore = reader.get_ignore();
+        snapshot.rules = reader.get_rules();
+        if (!reader.at_end()) return std::nullopt;
+
+        if (touched) {
+            // Same content under a new modification time: record the new time
+            // so the next run can skip hashing again.
+            try {
+                snapshot.save(source, current);
+            } catch (const std::exception&) {
+            }
+        }
+        return snapshot;
+    } catch (const std::exception&) {
+        return std::nullopt;
+    }
+}
+
+void SettingsSnapshot::save(const std::filesystem::path& source, const SourceStamp& stamp) const {
+    SnapshotWriter writer;
+    for (char c : SNAPSHOT_MAGIC) writer.put(c);
+    writer.put_string(canonical_source(source));
+    writer.put(stamp.size);
+    writer.put(stamp.mtime);
+    writer.put(stamp.hash);
+
+    writer.put_variables(variables);
+    writer.put(static_cast<std::uint32_t>(profiles.size()));
+    for (const auto& [name, profile] : profiles) {
+        writer.put_string(name);
+        writer.put_variables(profile.get_variables());
+        writer.put_ignore(profile.get_ignore());
+        std::map<std::string, std::string> profile_rules;
+        for (const auto& [rule_name, rule_value] : profile.get_rules()) {
+            profile_rules[rule_name] = rule_value.as_string();
+        }
+        writer.put_rules(profile_rules);
+    }
+    writer.put_ignore(ignore);
+    writer.put_rules(rules);
+
+    std::filesystem::path snapshot_path = path_for(source);
+    if (snapshot_path.empty()) {
+        throw std::runtime_error("Could not write settings snapshot: HOME is not set");
+    }
+    std::filesystem::create_directories(snapshot_path.parent_path());
+    std::filesystem::path temp_path = snapshot_path;
+    temp_path += "." + std::to_string(::getpid());
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("Could not write settings snapshot: " + temp_path.string());
+        }
+        out.write(writer.data().data(), static_cast<std::streamsize>(writer.data().size()));
+        if (!out) {
+            std::filesystem::remove(temp_path);
+            throw std::runtime_error("Could not write settings snapshot: " + temp_path.string());
+        }
+    }
+    try {
+        std::filesystem::rename(temp_path, snapshot_path);
+    } catch (const std::filesystem::filesystem_error&) {
+        std::error_code error;
+        std::filesystem::remove(temp_path, error);
+        throw;
+    }
+}
+
+} // namespace prebyte
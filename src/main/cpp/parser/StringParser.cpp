@@ -3,23 +3,16 @@
 namespace prebyte {
 
 Data StringParser::parse(const std::string& input, ParserType parserType) {
-        Parser* parser;
-
         switch (parserType) {
                 case ParserType::JSON:
-                        parser = new JsonParser();
-                        break;
                 case ParserType::YAML:
-                        parser = new YamlParser();
-                        break;
                 case ParserType::TOML:
-                        parser = new TomlParser();
                         break;
                 default:
                         throw std::runtime_error("Unsupported parser type");
         }
         try {
-                return parser->parse_string(input);
+                return FileParser::get_parser(parserType).parse_string(input);
         } catch (const std::exception& e) {
                 throw std::runtime_error("Error parsing input: " + std::string(e.what()));
         }
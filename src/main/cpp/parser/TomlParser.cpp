@@ -16,16 +16,16 @@ Data convert_array(const std::shared_ptr<cpptoml::array>& arr) {
 Data convert_table(const std::shared_ptr<cpptoml::table>& table) {
     Data::Map map;
     for (const auto& [key, value] : *table) {
-        map[key] = convert_toml_value(value);
+        map.append(key, convert_toml_value(value));
     }
-    return Data(map);
+    return Data(std::move(map));
 }
 
 Data convert_toml_value(const std::shared_ptr<cpptoml::base>& val) {
     if (auto v = val->as<std::string>()) {
         return Data(v->get());
     } else if (auto v = val->as<int64_t>()) {
-        return Data(static_cast<int>(v->get()));
+        return Data(static_cast<std::int64_t>(v->get()));
     } else if (auto v = val->as<double>()) {
         return Data(v->get());
     } else if (auto v = val->as<bool>()) {
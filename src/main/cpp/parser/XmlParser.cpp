@@ -1,5 +1,10 @@
 #include "parser/XmlParser.h"
 
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 namespace prebyte {
 
 Data convert_xml_node(const pugi::xml_node& node) {
@@ -9,33 +14,39 @@ Data convert_xml_node(const pugi::xml_node& node) {
         return std::string(node.value());
     }
 
+    // Children are grouped by name in a single pass. Names point into the
+    // document, which outlives this call, so the index needs no copies.
+    std::vector<std::pair<std::string_view, Data::Array>> groups;
+    std::unordered_map<std::string_view, std::size_t> group_index;
+
+    for (auto child : node.children()) {
+        std::string_view name = child.name();
+        if (name.empty()) continue;
+
+        auto [it, inserted] = group_index.try_emplace(name, groups.size());
+        if (inserted) {
+            groups.emplace_back(name, Data::Array());
+        }
+        groups[it->second].second.push_back(convert_xml_node(child));
+    }
+
     Data::Map map;
+    map.reserve(groups.size() + 1);
 
     for (auto attr : node.attributes()) {
-        map["@" + std::string(attr.name())] = std::string(attr.value());
+        map.append("@" + std::string(attr.name()), std::string(attr.value()));
     }
 
     std::string text = node.child_value();
     if (!text.empty() && node.first_child().type() == pugi::node_pcdata) {
-        map["_text"] = text;
+        map.append("_text", std::move(text));
     }
 
-    for (auto child : node.children()) {
-        std::string name = child.name();
-        if (name.empty()) continue;
-
-        if (map.find(name) == map.end()) {
-            map[name] = convert_xml_node(child);
+    for (auto& [name, elements] : groups) {
+        if (elements.size() == 1) {
+            map.append(std::string(name), std::move(elements.front()));
         } else {
-            Data existing = map[name];
-            if (!existing.is_array()) {
-                Data::Array arr = { existing };
-                existing = Data(std::move(arr));
-            }
-
-            Data::Array copy = existing.as_array();
-            copy.push_back(convert_xml_node(child));
-            map[name] = Data(std::move(copy));
+            map.append(std::string(name), Data(std::move(elements)));
         }
     }
 
@@ -71,4 +82,20 @@ Data XmlParser::parse_string(const std::string& input) {
     return convert_xml_node(doc.document_element());
 }
 
+void XmlParser::for_each_element(const std::filesystem::path& filepath, const ElementCallback& callback) {
+    pugi::xml_document doc;
+    pugi::xml_parse_result result = doc.load_file(filepath.c_str());
+
+    if (!result) {
+        throw std::runtime_error("Failed to parse XML: " + std::string(result.description()));
+    }
+
+    for (auto child : doc.document_element().children()) {
+        if (child.type() != pugi::node_element) continue;
+
+        Data element = convert_xml_node(child);
+        if (!callback(element)) return;
+    }
+}
+
 } // namespace prebyte
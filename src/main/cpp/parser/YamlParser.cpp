@@ -3,40 +3,111 @@
 
 namespace prebyte {
 
+namespace {
+
+bool all_of_base(std::string_view digits, int base) {
+    if (digits.empty()) return false;
+    for (char c : digits) {
+        bool valid = base == 16 ? std::isxdigit(static_cast<unsigned char>(c)) : (c >= '0' && c < '0' + base);
+        if (!valid) return false;
+    }
+    return true;
+}
+
+std::optional<Data> parse_integer(std::string_view text, int base) {
+    std::int64_t number;
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), number, base);
+    if (ec == std::errc() && ptr == text.data() + text.size()) return Data(number);
+    return std::nullopt;
+}
+
+bool is_float(std::string_view value) {
+    std::size_t i = 0;
+    std::size_t digits = 0;
+    while (i < value.size() && std::isdigit(static_cast<unsigned char>(value[i]))) { ++i; ++digits; }
+    if (i < value.size() && value[i] == '.') {
+        ++i;
+        while (i < value.size() && std::isdigit(static_cast<unsigned char>(value[i]))) { ++i; ++digits; }
+    }
+    if (digits == 0) return false;
+    if (i < value.size() && (value[i] == 'e' || value[i] == 'E')) {
+        ++i;
+        if (i < value.size() && (value[i] == '+' || value[i] == '-')) ++i;
+        if (i == value.size()) return false;
+        while (i < value.size() && std::isdigit(static_cast<unsigned char>(value[i]))) ++i;
+    }
+    return i == value.size();
+}
+
+}
+
+Data YamlParser::convert_scalar(const std::string& value) {
+    std::string_view text = value;
+    if (text.empty() || text == "~" || text == "null" || text == "Null" || text == "NULL") return Data();
+    if (text == "true" || text == "True" || text == "TRUE") return Data(true);
+    if (text == "false" || text == "False" || text == "FALSE") return Data(false);
+
+    char first = text.front();
+    if (!std::isdigit(static_cast<unsigned char>(first)) && first != '-' && first != '+' && first != '.') {
+        return Data(value);
+    }
+
+    if (text.starts_with("0x")) {
+        if (all_of_base(text.substr(2), 16)) {
+            if (auto number = parse_integer(text.substr(2), 16)) return std::move(*number);
+        }
+        return Data(value);
+    }
+    if (text.starts_with("0o")) {
+        if (all_of_base(text.substr(2), 8)) {
+            if (auto number = parse_integer(text.substr(2), 8)) return std::move(*number);
+        }
+        return Data(value);
+    }
+
+    bool negative = first == '-';
+    std::string_view unsigned_text = (first == '-' || first == '+') ? text.substr(1) : text;
+
+    if (unsigned_text == ".inf" || unsigned_text == ".Inf" || unsigned_text == ".INF") {
+        return Data(negative ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity());
+    }
+    if (text == ".nan" || text == ".NaN" || text == ".NAN") {
+        return Data(std::numeric_limits<double>::quiet_NaN());
+    }
+
+    if (all_of_base(unsigned_text, 10)) {
+        if (auto number = parse_integer(first == '+' ? unsigned_text : text, 10)) return std::move(*number);
+    }
+    if (is_float(unsigned_text)) {
+        double number;
+        auto [ptr, ec] = std::from_chars(unsigned_text.data(), unsigned_text.data() + unsigned_text.size(), number);
+        if (ec == std::errc() && ptr == unsigned_text.data() + unsigned_text.size()) return Data(negative ? -number : number);
+    }
+    return Data(value);
+}
+
 Data convert_yaml(const YAML::Node& node) {
     if (!node) return Data();
 
     if (node.IsNull()) {
         return Data();
     } else if (node.IsScalar()) {
-        std::string value = node.Scalar();
-
-        if (value == "true" || value == "false") {
-            return Data(value == "true");
-        }
-
-        static const std::regex int_regex(R"(^-?\d+$)");
-        if (std::regex_match(value, int_regex)) {
-            return Data(std::stoi(value));
+        if (node.Tag() == "!") {
+            return Data(node.Scalar());
         }
-
-        static const std::regex float_regex(R"(^-?\d+\.\d+$)");
-        if (std::regex_match(value, float_regex)) {
-            return Data(std::stod(value));
-        }
-
-        return Data(value);
+        return YamlParser::convert_scalar(node.Scalar());
     } else if (node.IsSequence()) {
         Data::Array arr;
+        arr.reserve(node.size());
         for (const auto& elem : node) {
             arr.push_back(convert_yaml(elem));
         }
         return Data(std::move(arr));
     } else if (node.IsMap()) {
         Data::Map map;
+        map.reserve(node.size());
         for (const auto& kv : node) {
-            const std::string key = kv.first.as<std::string>();
-            map[key] = convert_yaml(kv.second);
+            map.append(kv.first.Scalar(), convert_yaml(kv.second));
         }
         return Data(std::move(map));
     }
@@ -0,0 +1,170 @@
+#include "processor/BatchProcessor.h"
+
+#include <thread>
+
+#include "datatypes/OutputFile.h"
+#include "processor/OrderedWorkers.h"
+
+namespace prebyte {
+
+BatchProcessor::BatchProcessor(std::unique_ptr<Context> context) : Processor() {
+        this->context = std::move(context);
+}
+
+void BatchProcessor::process() {
+        this->context->logger->info("Starting multi-row rendering...");
+        std::string input = get_input();
+        if (input.empty()) {
+                this->context->logger->warn("Input is empty. Exiting multi-row rendering.");
+                return;
+        }
+
+        std::vector<Row> rows;
+        try {
+                FileParser file_parser;
+                rows = get_rows(file_parser.parse(this->context->rows_source));
+        } catch (const std::exception& e) {
+                this->context->logger->error("Error reading row source '{}': {}", this->context->rows_source, e.what());
+                end(this->context.get());
+        }
+        this->context->logger->debug("Loaded {} rows from {}", rows.size(), this->context->rows_source);
+
+        if (!this->context->rows_output.empty()) {
+                Template name_pattern = Template::compile(this->context->rows_output, this->context->rules.variable_prefix.value(), this->context->rules.variable_suffix.value());
+                std::unique_ptr<Preprocessor> name_preprocessor;
+                render_rows(input, rows, [this, &name_pattern, &name_preprocessor, &rows](std::size_t index, std::string& output) {
+                        write_row_file(render_row(name_preprocessor, name_pattern, rows[index], index), output);
+                });
+                return;
+        }
+
+        std::unique_ptr<OutputFile> output_file;
+        std::ostream* out = &std::cout;
+        if (this->context->action_type == ActionType::FILE_IN_FILE_OUT || this->context->action_type == ActionType::STDIN_FILE_OUT) {
+                std::filesystem::path output_path = this->context->action_type == ActionType::FILE_IN_FILE_OUT ? this->context->inputs[1] : this->context->inputs[0];
+                try {
+                        output_file = std::make_unique<OutputFile>(output_path, this->context->rules.skip_unchanged_output.value_or(false));
+                } catch (const std::exception& e) {
+                        this->context->logger->error(e.what());
+                        end(this->context.get());
+                }
+                this->context->logger->debug("Writing output to file: " + output_path.string());
+                out = &output_file->stream();
+        }
+        render_rows(input, rows, [out](std::size_t, std::string& output) {
+                *out << output;
+        });
+        if (output_file) {
+                try {
+                        if (!output_file->commit()) {
+                                this->context->logger->debug("Output file is unchanged, keeping it");
+                        }
+                } catch (const std::exception& e) {
+                        this->context->logger->error(e.what());
+                        end(this->context.get());
+                }
+        }
+}
+
+void BatchProcessor::render_rows(const std::string& input, const std::vector<Row>& rows, const RowCallback& callback) {
+        Template compiled = Template::compile(input, this->context->rules.variable_prefix.value(), this->context->rules.variable_suffix.value());
+
+        std::size_t thread_count = get_thread_count(rows.size());
+        this->context->logger->debug("Rendering {} rows with {} thread(s)", rows.size(), thread_count);
+
+        std::vector<std::unique_ptr<Preprocessor>> preprocessors(thread_count);
+        try {
+                run_ordered(rows.size(), thread_count,
+                            [this, &compiled, &rows, &preprocessors](std::size_t index, std::size_t worker) {
+                                    return render_row(preprocessors[worker], compiled, rows[index], index);
+                            },
+                            callback);
+        } catch (const std::exception&) {
+                // All workers have stopped here, so the CLI can exit safely.
+                if (this->context->is_api) throw;
+                end(this->context.get());
+        }
+}
+
+std::string BatchProcessor::render_row(std::unique_ptr<Preprocessor>& preprocessor, const Template& compiled, const Row& row, std::size_t index) const {
+        if (!preprocessor) {
+                auto row_context = std::make_unique<Context>(*this->context);
+                row_context->output_sink = nullptr;
+                // Errors of a row throw, so they end the render on the calling thread instead of a worker.
+                row_context->is_api = true;
+                preprocessor = std::make_unique<Preprocessor>(std::move(row_context));
+        }
+
+        Row variables = row;
+        variables["ROW_INDEX"] = {std::to_string(index)};
+        std::string output = preprocessor->render(compiled, variables);
+        if (preprocessor->changed_context()) {
+                this->context->logger->trace("Row {} changed the context, starting the next row from a fresh copy", index);
+                preprocessor.reset();
+        }
+        return output;
+}
+
+std::size_t BatchProcessor::get_thread_count(std::size_t row_count) const {
+        std::size_t threads = static_cast<std::size_t>(this->context->rules.batch_threads.value_or(1));
+        if (threads == 0) {
+                threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        return std::max<std::size_t>(1, std::min(threads, row_count));
+}
+
+void BatchProcessor::write_row_file(const std::filesystem::path& path, const std::string& output) const {
+        if (path.empty()) {
+                this->context->logger->error("Output pattern '{}' rendered to an empty file name.", this->context->rows_output);
+                throw std::runtime_error("Output pattern rendered to an empty file name");
+        }
+        if (path.has_parent_path()) {
+                std::error_code ec;
+                std::filesystem::create_directories(path.parent_path(), ec);
+        }
+        this->context->logger->debug("Writing row output to file: " + path.string());
+        try {
+                if (!OutputFile::write(path, output, this->context->rules.skip_unchanged_output.value_or(false))) {
+                        this->context->logger->debug("Row output file is unchanged, keeping: " + path.string());
+                }
+        } catch (const std::exception& e) {
+                this->context->logger->error(e.what());
+                throw;
+        }
+}
+
+std::vector<BatchProcessor::Row> BatchProcessor::get_rows(const Data& data) {
+        if (!data.is_array()) {
+                throw std::runtime_error("Row source must contain a list of rows.");
+        }
+        std::vector<Row> rows;
+        rows.reserve(data.as_array().size());
+        for (const Data& entry : data.as_array()) {
+                if (!entry.is_map()) {
+                        throw std::runtime_error("Every row must be a map of variable names to values.");
+                }
+                Row row;
+                for (const auto& [name, value] : entry.as_map()) {
+                        if (value.is_null()) {
+                                row[name] = {""};
+                        } else if (value.is_array()) {
+                                std::vector<std::string> values;
+                                for (const Data& item : value.as_array()) {
+                                        if (item.is_array() || item.is_map()) {
+                                                throw std::runtime_error("Row value for '" + name + "' must not contain nested lists or maps.");
+                                        }
+                                        values.push_back(item.is_null() ? "" : item.as_string());
+                                }
+                                row[name] = std::move(values);
+                        } else if (value.is_map()) {
+                                throw std::runtime_error("Row value for '" + name + "' must not be a map.");
+                        } else {
+                                row[name] = {value.as_string()};
+                        }
+                }
+                rows.push_back(std::move(row));
+        }
+        return rows;
+}
+
+}
@@ -0,0 +1,90 @@
+#include "processor/ConditionEvaluator.h"
+
+#include <regex>
+
+namespace prebyte {
+
+ConditionEvaluator::Result ConditionEvaluator::evaluate(const std::string& expr) const {
+        return evaluate_or(expr);
+}
+
+ConditionEvaluator::Result ConditionEvaluator::evaluate_or(const std::string& expr) const {
+        int parens = 0;
+        for (std::size_t i = 0; i + 1 < expr.size(); ++i) {
+                if (expr[i] == '(') parens++;
+                if (expr[i] == ')') parens--;
+                if (parens == 0 && expr[i] == '|' && expr[i+1] == '|') {
+                        Result left = evaluate(trim(expr.substr(0, i)));
+                        Result right = evaluate(trim(expr.substr(i + 2)));
+                        if (left.value == true || right.value == true) return {true};
+                        if (left.value == false) return right;
+                        if (right.value == false) return left;
+                        return {std::nullopt, left.residual + " || " + right.residual};
+                }
+        }
+        return evaluate_and(expr);
+}
+
+ConditionEvaluator::Result ConditionEvaluator::evaluate_and(const std::string& expr) const {
+        int parens = 0;
+        for (std::size_t i = 0; i + 1 < expr.size(); ++i) {
+                if (expr[i] == '(') parens++;
+                if (expr[i] == ')') parens--;
+                if (parens == 0 && expr[i] == '&' && expr[i+1] == '&') {
+                        Result left = evaluate(trim(expr.substr(0, i)));
+                        Result right = evaluate(trim(expr.substr(i + 2)));
+                        if (left.value == false || right.value == false) return {false};
+                        if (left.value == true) return right;
+                        if (right.value == true) return left;
+                        return {std::nullopt, left.residual + " && " + right.residual};
+                }
+        }
+        return evaluate_not(expr);
+}
+
+ConditionEvaluator::Result ConditionEvaluator::evaluate_not(const std::string& expr) const {
+        std::string trimmed = trim(expr);
+        if (trimmed.starts_with('!')) {
+                Result inner = evaluate(trimmed.substr(1));
+                if (inner.value) return {!*inner.value};
+                return {std::nullopt, "!" + inner.residual};
+        }
+        if (trimmed.starts_with('(') && trimmed.ends_with(')')) {
+                Result inner = evaluate(trimmed.substr(1, trimmed.size() - 2));
+                if (inner.value) return inner;
+                return {std::nullopt, "(" + inner.residual + ")"};
+        }
+        return evaluate_comparison(trimmed);
+}
+
+ConditionEvaluator::Result ConditionEvaluator::evaluate_comparison(const std::string& expr) const {
+        static const std::regex cmp_regex(R"(^\s*([a-zA-Z][a-zA-Z0-9_.@]*|".*")\s*(==|!=)\s*([a-zA-Z][a-zA-Z0-9_.@]*|".*")\s*$)");
+        std::smatch match;
+        if (std::regex_match(expr, match, cmp_regex)) {
+                Operand left = resolve_operand(match[1]);
+                std::string op = match[2];
+                Operand right = resolve_operand(match[3]);
+                if (left.defined && right.defined) return {op == "==" ? left.value == right.value : left.value != right.value};
+                return {std::nullopt, left.residual + " " + op + " " + right.residual};
+        }
+
+        Operand variable = this->resolver(expr);
+        if (variable.defined) return {*variable.defined};
+        return {std::nullopt, variable.residual};
+}
+
+ConditionEvaluator::Operand ConditionEvaluator::resolve_operand(const std::string& token) const {
+        std::string t = trim(token);
+        if (t.starts_with('"') && t.ends_with('"')) {
+                return {true, t.substr(1, t.size() - 2), t};
+        }
+        return this->resolver(t);
+}
+
+std::string ConditionEvaluator::trim(const std::string& s) {
+        size_t start = s.find_first_not_of(" \t");
+        size_t end = s.find_last_not_of(" \t");
+        return (start == std::string::npos) ? "" : s.substr(start, end - start + 1);
+}
+
+}
@@ -10,8 +10,13 @@ std::unique_ptr<Context> ContextProcessor::process() {
         this->set_logger();
         this->context->rules.init();
         this->context->start_time = cli_struct.start_time;
-        load_settings();
         load_action_type();
+        if (!needs_settings()) {
+                this->context->logger->debug("Action does not use settings, skipping settings file");
+                return std::move(context);
+        }
+        enable_file_log();
+        load_settings();
         load_profiles();
         load_variables();
         load_ignore();
@@ -23,9 +28,37 @@ void ContextProcessor::load_action_type() {
         this->context->logger->debug("Loading action type from CLI struct");
         context->action_type = cli_struct.action;
         context->inputs = cli_struct.input_args;
+        context->rows_source = cli_struct.rows_file;
+        context->rows_output = cli_struct.rows_output;
+        if (!context->rows_output.empty() && context->rows_source.empty()) {
+                this->context->logger->error("--rows-output requires a row source given with --rows.");
+                end(this->context.get());
+        }
+        context->specialize = cli_struct.specialize;
+        context->constants = cli_struct.constants;
+        if (!context->constants.empty() && !context->specialize) {
+                this->context->logger->error("--constant requires --specialize.");
+                end(this->context.get());
+        }
+        if (context->specialize && !context->rows_source.empty()) {
+                this->context->logger->error("--specialize cannot be combined with --rows.");
+                end(this->context.get());
+        }
         this->context->logger->debug("Action type set to: {}", static_cast<int>(context->action_type));
 }
 
+bool ContextProcessor::needs_settings() const {
+        switch (context->action_type) {
+                case ActionType::HELP:
+                case ActionType::HARD_HELP:
+                case ActionType::EXPLAIN:
+                case ActionType::VERSION:
+                        return false;
+                default:
+                        return true;
+        }
+}
+
 std::optional<std::filesystem::path> ContextProcessor::find_settings_file(const std::filesystem::path& dir) const {
     this->context->logger->info("Searching for settings file in directory: {}", dir.string());
     if (!std::filesystem::exists(dir) || !std::filesystem::is_directory(dir)) return std::nullopt;
@@ -35,19 +68,13 @@ std::optional<std::filesystem::path> ContextProcessor::find_settings_file(const
         ".json", ".yaml", ".yml", ".toml"
     };
 
-    for (const auto& entry : std::filesystem::directory_iterator(dir)) {
-        if (!entry.is_regular_file()) continue;
-
-        const std::filesystem::path& path = entry.path();
+    for (const std::string& ext : valid_extensions) {
+        std::filesystem::path path = dir / (target_stem + ext);
         this->context->logger->trace("Checking file as potential settings file: {}", path.string());
-        if (path.stem() == target_stem) {
-            this->context->logger->trace("File stem matches target: {}", path.stem().string());
-            std::string ext = path.extension().string();
-            this->context->logger->trace("File extension: {}", ext);
-            if (std::find(valid_extensions.begin(), valid_extensions.end(), ext) != valid_extensions.end()) {
-                this->context->logger->debug("Found settings file: {}", path.string());
-                return path;
-            }
+        std::error_code error;
+        if (std::filesystem::is_regular_file(path, error)) {
+            this->context->logger->debug("Found settings file: {}", path.string());
+            return path;
         }
     }
     this->context->logger->debug("No settings file found in directory: {}", dir.string());
@@ -70,9 +97,25 @@ void ContextProcessor::load_settings() {
                 settings_path = *std_settings_path;
                 this->context->logger->debug("Using default settings file: {}", settings_path.string());
         }
+        if (auto snapshot = SettingsSnapshot::load(settings_path)) {
+                this->context->logger->info("Using settings snapshot for: {}", settings_path.string());
+                apply_settings(*snapshot);
+                return;
+        }
+
+        SettingsSnapshot::SourceStamp stamp;
+        bool stamped = false;
+        try {
+                stamp = SettingsSnapshot::stamp(settings_path);
+                stamped = true;
+        } catch (const std::exception& e) {
+                this->context->logger->debug("Could not stamp settings file: {}", e.what());
+        }
+
         FileParser file_parser;
         Data settings_data = file_parser.parse(settings_path);
         this->context->logger->info("Processing settings file: {}", settings_path.string());
+        SettingsSnapshot snapshot;
         if (settings_data.is_map()) {
                 Data variables = settings_data["variables"];
                 Data profiles  = settings_data["profiles"];
@@ -80,21 +123,40 @@ void ContextProcessor::load_settings() {
                 Data rules     = settings_data["rules"];
                 if (!variables.is_null()) {
                         this->context->logger->debug("Loading variables from settings file");
-                        context->variables = get_variables(variables);
+                        snapshot.variables = get_variables(variables);
                 }
                 if (!profiles.is_null()) {
                         this->context->logger->debug("Loading profiles from settings file");
-                        context->profiles = get_profiles(profiles);
+                        snapshot.profiles = get_profiles(profiles);
                 }
                 if (!ignore.is_null()) {
                         this->context->logger->debug("Loading ignore items from settings file");
-                        context->ignore = get_ignore(ignore);
+                        snapshot.ignore = get_ignore(ignore);
                 }
                 if (!rules.is_null()) {
                         this->context->logger->debug("Loading rules from settings file");
-                        load_rules(get_rules(rules));
+                        snapshot.rules = get_rules(rules);
                 }
         }
+
+        if (stamped) {
+                try {
+                        snapshot.save(settings_path, stamp);
+                        this->context->logger->debug("Wrote settings snapshot: {}", SettingsSnapshot::path_for(settings_path).string());
+                } catch (const std::exception& e) {
+                        this->context->logger->debug("Could not write settings snapshot: {}", e.what());
+                }
+        }
+        apply_settings(snapshot);
+}
+
+void ContextProcessor::apply_settings(SettingsSnapshot& settings) {
+        context->variables = std::move(settings.variables);
+        context->profiles = std::move(settings.profiles);
+        context->ignore = std::move(settings.ignore);
+        if (!settings.rules.empty()) {
+                load_rules(settings.rules);
+        }
 }
 
 void ContextProcessor::load_profiles() {
@@ -277,8 +339,8 @@ std::map<std::string,std::vector<std::string>> ContextProcessor::get_variables(c
                         this->context->logger->trace("Variable: '{}' is a string with value: '{}'", variable_name, value.as_string());
                         variable_list[variable_name] = {value.as_string()};
                 } else if (value.is_int()) {
-                        this->context->logger->trace("Variable: '{}' is an integer with value: {}", variable_name, value.as_int());
-                        variable_list[variable_name] = {std::to_string(value.as_int())};
+                        this->context->logger->trace("Variable: '{}' is an integer with value: {}", variable_name, value.as_int64());
+                        variable_list[variable_name] = {std::to_string(value.as_int64())};
                 } else if (value.is_double()) {
                         this->context->logger->trace("Variable: '{}' is a double with value: {}", variable_name, value.as_double());
                         variable_list[variable_name] = {std::to_string(value.as_double())};
@@ -297,8 +359,8 @@ std::map<std::string,std::vector<std::string>> ContextProcessor::get_variables(c
                                         this->context->logger->trace("Array item for variable: '{}' is a string with value: '{}'", variable_name, item.as_string());
                                         variable_list[variable_name] = {item.as_string()};
                                 } else if (item.is_int()) {
-                                        this->context->logger->trace("Array item for variable: '{}' is an integer with value: {}", variable_name, item.as_int());
-                                        variable_list[variable_name] = {std::to_string(item.as_int())};
+                                        this->context->logger->trace("Array item for variable: '{}' is an integer with value: {}", variable_name, item.as_int64());
+                                        variable_list[variable_name] = {std::to_string(item.as_int64())};
                                 } else if (item.is_double()) {
                                         this->context->logger->trace("Array item for variable: '{}' is a double with value: {}", variable_name, item.as_double());
                                         variable_list[variable_name] = {std::to_string(item.as_double())};
@@ -412,8 +474,8 @@ void ContextProcessor::set_logger() {
                 return;
         }
         pid_t pid = getpid();
-        auto file_sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(expand_tilde("~/.prebyte/prebyte.log"), false);
-        file_sink->set_level(spdlog::level::trace);
+        auto file_sink = std::make_shared<LazyFileSink>(expand_tilde("~/.prebyte/prebyte.log"));
+        file_sink->set_level(spdlog::level::off);
         std::string file_pattern = "(%Y-%m-%d %H:%M:%S.%e) {" + std::to_string(pid) + "} [%l] %v";
         file_sink->set_pattern(file_pattern);
 
@@ -438,9 +500,16 @@ void ContextProcessor::set_logger() {
         console_sink->set_pattern("%^[%l] %v%$");
 
         context->console_sink = console_sink;
+        context->file_sink = file_sink;
 
         context->logger = std::make_shared<spdlog::logger>("prebyte", spdlog::sinks_init_list{file_sink, console_sink});
-        context->logger->set_level(spdlog::level::trace);
+        context->logger->set_level(console_sink->level());
+}
+
+void ContextProcessor::enable_file_log() {
+        if (!this->context->file_sink) return;
+        this->context->file_sink->set_level(spdlog::level::trace);
+        this->context->logger->set_level(spdlog::level::trace);
 }
 
 std::string ContextProcessor::expand_tilde(const std::string& path) {
@@ -0,0 +1,84 @@
+#include "processor/Directive.h"
+
+namespace prebyte {
+
+namespace {
+
+/**
+ * Splits the word starting at `offset` off the action. `next` receives the offset
+ * behind the following space, `has_arguments` whether there was a space at all.
+ */
+std::string_view next_word(std::string_view action, std::size_t offset, std::size_t& next, bool& has_arguments) {
+        std::size_t space = action.find(' ', offset);
+        has_arguments = space != std::string_view::npos;
+        next = has_arguments ? space + 1 : action.size();
+        return action.substr(offset, has_arguments ? space - offset : std::string_view::npos);
+}
+
+/// Classifies the second keyword of `set`, `unset` and `define`, which always takes arguments.
+Directive sub_directive(std::string_view action, std::size_t offset, std::string_view keyword) {
+        std::size_t next;
+        bool has_arguments;
+        std::string_view word = next_word(action, offset, next, has_arguments);
+        if (!has_arguments) return {};
+
+        FlowType type = FlowType::NONE;
+        if (keyword == "set") {
+                if (word == "var") type = FlowType::SET_VAR;
+                else if (word == "rule") type = FlowType::SET_RULE;
+                else if (word == "profile") type = FlowType::SET_PROFILE;
+                else if (word == "ignore" || word == "igno") type = FlowType::SET_IGNORE;
+        } else if (keyword == "unset") {
+                if (word == "var") type = FlowType::UNSET_VAR;
+                else if (word == "ignore") type = FlowType::UNSET_IGNORE;
+        } else {
+                if (word == "macro") type = FlowType::DEFINE_MACRO;
+                else if (word == "profile") type = FlowType::DEFINE_PROFILE;
+        }
+        if (type == FlowType::NONE) return {};
+        return {type, next};
+}
+
+}
+
+Directive Directive::parse(std::string_view action) {
+        std::size_t next;
+        bool has_arguments;
+        std::string_view keyword = next_word(action, 0, next, has_arguments);
+        if (keyword.empty()) return {};
+
+        // Keywords with arguments need the separating space; block ends must stand alone.
+        switch (keyword.front()) {
+                case 'd':
+                        if (has_arguments && (keyword == "def" || keyword == "define")) return sub_directive(action, next, "define");
+                        break;
+                case 'e':
+                        if (has_arguments) {
+                                if (keyword == "elif") return {FlowType::ELSE_IF, next};
+                                if (keyword == "exec") return {FlowType::EXECUTE_MACRO, next};
+                        } else {
+                                if (keyword == "else") return {FlowType::ELSE, next};
+                                if (keyword == "endif") return {FlowType::ENDIF, next};
+                                if (keyword == "endfor") return {FlowType::ENDFOR, next};
+                                if (keyword == "enddef") return {FlowType::END_DEFINE, next};
+                        }
+                        break;
+                case 'f':
+                        if (has_arguments && keyword == "for") return {FlowType::FOR, next};
+                        break;
+                case 'i':
+                        if (has_arguments && keyword == "if") return {FlowType::IF, next};
+                        if (has_arguments && keyword == "include") return {FlowType::INCLUDE, next};
+                        if (has_arguments && keyword == "include_once") return {FlowType::INCLUDE_ONCE, next};
+                        break;
+                case 's':
+                        if (has_arguments && keyword == "set") return sub_directive(action, next, "set");
+                        break;
+                case 'u':
+                        if (has_arguments && keyword == "unset") return sub_directive(action, next, "unset");
+                        break;
+        }
+        return {};
+}
+
+}
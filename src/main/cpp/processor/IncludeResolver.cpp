@@ -0,0 +1,37 @@
+#include "processor/IncludeResolver.h"
+
+namespace prebyte {
+
+std::optional<std::filesystem::path> IncludeResolver::resolve(std::string_view request, const Rules& rules) {
+        std::string_view current_path = rules.include_path ? std::string_view(*rules.include_path) : std::string_view();
+        if (current_path != this->include_path) {
+                this->include_path = std::string(current_path);
+                this->directories = rules.get_include_dirs();
+                this->cache.clear();
+        }
+
+        auto cached = this->cache.find(request);
+        if (cached != this->cache.end()) {
+                return cached->second;
+        }
+        std::optional<std::filesystem::path> resolved = lookup(std::filesystem::path(request));
+        this->cache.emplace(std::string(request), resolved);
+        return resolved;
+}
+
+std::optional<std::filesystem::path> IncludeResolver::lookup(const std::filesystem::path& request) const {
+        // canonical() both checks that the file exists and normalizes the path, so
+        // every candidate costs a single resolution.
+        std::error_code error;
+        std::filesystem::path resolved = std::filesystem::canonical(request, error);
+        if (!error) return resolved;
+        if (request.is_absolute()) return std::nullopt;
+
+        for (const auto& directory : this->directories) {
+                resolved = std::filesystem::canonical(directory / request, error);
+                if (!error) return resolved;
+        }
+        return std::nullopt;
+}
+
+}
@@ -0,0 +1,86 @@
+#include "processor/IncludeStore.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "parser/ContentHash.h"
+#include "parser/MappedFile.h"
+
+namespace prebyte {
+
+IncludeStore& IncludeStore::shared() {
+        static IncludeStore store;
+        return store;
+}
+
+std::shared_ptr<const IncludedFile> IncludeStore::load(const std::filesystem::path& path) {
+        std::error_code error;
+        std::uintmax_t size = std::filesystem::file_size(path, error);
+        if (error) {
+                throw std::runtime_error("Error opening include file: " + path.string());
+        }
+        std::filesystem::file_time_type mtime = std::filesystem::last_write_time(path, error);
+        if (error) {
+                throw std::runtime_error("Error opening include file: " + path.string());
+        }
+
+        std::string key = path.string();
+        {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                auto known = this->paths.find(key);
+                if (known != this->paths.end() && known->second.size == size && known->second.mtime == mtime) {
+                        return known->second.file;
+                }
+        }
+
+        // Read outside the lock; another thread may read the same file meanwhile,
+        // which only costs time since `intern` keeps a single copy either way.
+        MappedFile file(path);
+        std::string content(file.view());
+
+        std::lock_guard<std::mutex> lock(this->mutex);
+        std::shared_ptr<const IncludedFile> stored = intern(std::move(content));
+        this->paths[key] = PathEntry{size, mtime, stored};
+        return stored;
+}
+
+std::size_t IncludeStore::retained_bytes() {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        std::size_t bytes = 0;
+        for (const auto& [hash, candidates] : this->contents) {
+                for (const auto& candidate : candidates) {
+                        if (std::shared_ptr<const IncludedFile> file = candidate.lock()) {
+                                bytes += sizeof(IncludedFile) + file->content.capacity();
+                        }
+                }
+        }
+        return bytes;
+}
+
+void IncludeStore::clear() {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->paths.clear();
+        this->contents.clear();
+}
+
+std::shared_ptr<const IncludedFile> IncludeStore::intern(std::string content) {
+        std::uint64_t hash = hash_content(content);
+        auto& candidates = this->contents[hash];
+        candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                        [](const auto& candidate) { return candidate.expired(); }),
+                         candidates.end());
+        for (const auto& candidate : candidates) {
+                std::shared_ptr<const IncludedFile> existing = candidate.lock();
+                if (existing && existing->content == content) {
+                        return existing;
+                }
+        }
+
+        auto stored = std::make_shared<IncludedFile>();
+        stored->hash = hash;
+        stored->content = std::move(content);
+        candidates.push_back(stored);
+        return stored;
+}
+
+}
@@ -0,0 +1,183 @@
+#include "processor/IncrementalRenderer.h"
+
+#include <algorithm>
+#include <string_view>
+
+namespace prebyte {
+
+namespace {
+
+/** Splits action text into the words that may name variables or macros. */
+void collect_words(std::string_view text, std::set<std::string>& words) {
+        constexpr std::string_view separators = " \t\r\n=!<>&|()\"',[]#{}";
+        std::size_t start = text.find_first_not_of(separators);
+        while (start != std::string_view::npos) {
+                std::size_t stop = text.find_first_of(separators, start);
+                words.emplace(text.substr(start, stop == std::string_view::npos ? std::string_view::npos : stop - start));
+                start = text.find_first_not_of(separators, stop);
+        }
+}
+
+}
+
+IncrementalRenderer::IncrementalRenderer(std::string input) : input(std::move(input)) {}
+
+void IncrementalRenderer::compile(Context& context) {
+        Template whole = Template::compile(this->input, context.rules.variable_prefix.value(), context.rules.variable_suffix.value());
+
+        this->plan = ParallelPlan::make(whole, BLOCK_SIZE);
+        this->blocks.clear();
+        if (this->plan.chunk_starts.empty()) {
+                this->parts.clear();
+                this->parts.push_back(std::move(whole));
+        } else {
+                const std::vector<Segment>& segments = whole.get_segments();
+                this->blocks.resize(this->plan.chunk_starts.size());
+                for (std::size_t i = 0; i < this->blocks.size(); ++i) {
+                        Block& block = this->blocks[i];
+                        std::size_t last = i + 1 < this->plan.chunk_starts.size() ? this->plan.chunk_starts[i + 1] : segments.size();
+                        for (std::size_t index = this->plan.chunk_starts[i]; index < last; ++index) {
+                                const Segment& segment = segments[index];
+                                if (segment.type != SegmentType::ACTION) continue;
+                                collect_words(segment.content, block.names);
+                                if (segment.directive.type == FlowType::FOR && segment.content.ends_with('"')) {
+                                        block.cacheable = false;
+                                }
+                        }
+                        for (const std::string& name : block.names) {
+                                if (name.starts_with('$') || (name.size() > 4 && name.starts_with("__") && name.ends_with("__"))) {
+                                        block.cacheable = false;
+                                }
+                        }
+                }
+                this->parts = std::move(whole).split(this->plan.chunk_starts);
+        }
+        this->compiled = true;
+        this->settings_revision = context.settings_revision;
+        context.logger->debug("Prepared incremental render with {} cached blocks", this->blocks.size());
+}
+
+std::string IncrementalRenderer::render(Preprocessor& preprocessor, Context& context) {
+        const std::string& prefix = context.rules.variable_prefix.value();
+        const std::string& suffix = context.rules.variable_suffix.value();
+        if (!this->compiled || this->settings_revision != context.settings_revision || !this->parts.front().matches(prefix, suffix)) {
+                compile(context);
+        }
+        this->reused_blocks = 0;
+        this->rendered_blocks = 0;
+
+        std::string output = preprocessor.render(this->parts.front());
+        if (this->blocks.empty()) {
+                return output;
+        }
+
+        if (!this->parts[1].matches(prefix, suffix) || !this->plan.macros_are_pure(context.macros, prefix, suffix)) {
+                context.logger->debug("Delimiters changed or a called macro changes state, rendering all blocks");
+                std::string rest;
+                for (std::size_t i = 1; i < this->parts.size(); ++i) {
+                        rest += this->parts[i].source_from(0);
+                }
+                output += preprocessor.render(Template::compile(rest, prefix, suffix));
+                for (Block& block : this->blocks) {
+                        block.valid = false;
+                }
+                this->rendered_blocks = this->blocks.size();
+                return output;
+        }
+
+        // Rules and ignores may be changed by the sequential part; the blocks only see the state after it.
+        if (this->rules != context.rules || this->ignore != context.ignore) {
+                context.logger->debug("Rules or ignores changed, dropping cached blocks");
+                for (Block& block : this->blocks) {
+                        block.valid = false;
+                }
+                this->rules = context.rules;
+                this->ignore = context.ignore;
+        }
+
+        bool reuse = !context.rules.allow_env_fallback.value_or(false);
+        auto binding = this->plan.loop_bindings.begin();
+        for (std::size_t i = 0; i < this->blocks.size(); ++i) {
+                Block& block = this->blocks[i];
+                if (reuse && block.cacheable && block.valid && is_current(block, context)) {
+                        output += block.output;
+                        this->reused_blocks++;
+                } else {
+                        std::vector<Dependency> dependencies;
+                        if (block.cacheable) {
+                                dependencies = capture(block, context);
+                                // `@path` values are read from the file on every render.
+                                block.cacheable = std::none_of(dependencies.begin(), dependencies.end(), [](const Dependency& dependency) {
+                                        return dependency.value && std::any_of(dependency.value->begin(), dependency.value->end(), [](const std::string& value) {
+                                                return value.starts_with("@") && !value.starts_with("@@");
+                                        });
+                                });
+                        }
+                        std::string block_output = preprocessor.render(this->parts[i + 1]);
+                        output += block_output;
+                        if (block.cacheable) {
+                                block.output = std::move(block_output);
+                                block.dependencies = std::move(dependencies);
+                                block.valid = true;
+                        }
+                        this->rendered_blocks++;
+                }
+
+                // A reused block does not run its loops, so set the variables they leave behind.
+                for (; binding != this->plan.loop_bindings.end() && binding->chunk == i; ++binding) {
+                        auto array = context.variables.find(binding->array);
+                        if (array != context.variables.end() && !array->second.empty()) {
+                                std::string last = array->second.back();
+                                context.variables[binding->variable] = {std::move(last)};
+                        }
+                }
+        }
+        context.logger->debug("Incremental render reused {} and rendered {} blocks", this->reused_blocks, this->rendered_blocks);
+        return output;
+}
+
+std::vector<IncrementalRenderer::Dependency> IncrementalRenderer::capture(const Block& block, const Context& context) const {
+        std::set<std::string> names = block.names;
+        std::vector<std::string> pending(names.begin(), names.end());
+        while (!pending.empty()) {
+                std::string name = std::move(pending.back());
+                pending.pop_back();
+                auto macro = context.macros.find(name);
+                if (macro == context.macros.end()) continue;
+                std::set<std::string> body_names;
+                collect_words(macro->second, body_names);
+                for (const std::string& body_name : body_names) {
+                        if (names.insert(body_name).second) pending.push_back(body_name);
+                }
+        }
+
+        std::vector<Dependency> dependencies;
+        dependencies.reserve(names.size());
+        for (const std::string& name : names) {
+                Dependency dependency{name, std::nullopt, std::nullopt};
+                if (auto variable = context.variables.find(name); variable != context.variables.end()) {
+                        dependency.value = variable->second;
+                }
+                if (auto macro = context.macros.find(name); macro != context.macros.end()) {
+                        dependency.macro = macro->second;
+                }
+                dependencies.push_back(std::move(dependency));
+        }
+        return dependencies;
+}
+
+bool IncrementalRenderer::is_current(const Block& block, const Context& context) const {
+        for (const Dependency& dependency : block.dependencies) {
+                auto variable = context.variables.find(dependency.name);
+                if (variable == context.variables.end() ? dependency.value.has_value() : (!dependency.value || *dependency.value != variable->second)) {
+                        return false;
+                }
+                auto macro = context.macros.find(dependency.name);
+                if (macro == context.macros.end() ? dependency.macro.has_value() : (!dependency.macro || *dependency.macro != macro->second)) {
+                        return false;
+                }
+        }
+        return true;
+}
+
+}
@@ -0,0 +1,45 @@
+#include "processor/MacroCache.h"
+
+namespace prebyte {
+
+void MacroCache::set_capacity(std::size_t capacity) {
+        this->capacity = capacity;
+        while (this->entries.size() > this->capacity) {
+                this->index.erase(this->entries.back().first);
+                this->entries.pop_back();
+        }
+}
+
+const std::string* MacroCache::find(const std::string& key) {
+        auto it = this->index.find(key);
+        if (it == this->index.end()) {
+                this->misses++;
+                return nullptr;
+        }
+        this->hits++;
+        this->entries.splice(this->entries.begin(), this->entries, it->second);
+        return &it->second->second;
+}
+
+void MacroCache::insert(const std::string& key, std::string output) {
+        if (this->capacity == 0) return;
+        auto it = this->index.find(key);
+        if (it != this->index.end()) {
+                it->second->second = std::move(output);
+                this->entries.splice(this->entries.begin(), this->entries, it->second);
+                return;
+        }
+        if (this->entries.size() == this->capacity) {
+                this->index.erase(this->entries.back().first);
+                this->entries.pop_back();
+        }
+        this->entries.emplace_front(key, std::move(output));
+        this->index.emplace(key, this->entries.begin());
+}
+
+void MacroCache::clear() {
+        this->entries.clear();
+        this->index.clear();
+}
+
+}
@@ -0,0 +1,75 @@
+#include "processor/MacroClassifier.h"
+
+#include <algorithm>
+
+namespace prebyte {
+
+MacroClassifier::MacroClassifier(Options options, BodyLookup lookup) : options(std::move(options)), lookup(std::move(lookup)) {
+}
+
+bool MacroClassifier::is_pure(const std::string& macro_name) {
+        if (this->options.declared_pure && this->options.declared_pure->contains(macro_name)) return true;
+        auto known = this->known.find(macro_name);
+        if (known != this->known.end()) return known->second;
+
+        std::shared_ptr<const Template> body = this->lookup(macro_name);
+        if (!body) return false;
+
+        // Recursive calls are checked as impure, which ends the recursion.
+        this->known[macro_name] = false;
+        bool pure = is_pure(body->get_segments(), 0, body->get_segments().size());
+        this->known[macro_name] = pure;
+        return pure;
+}
+
+bool MacroClassifier::is_pure(const std::vector<Segment>& segments, std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; ++i) {
+                const Segment& segment = segments[i];
+                if (segment.unterminated) return false;
+                if (segment.type != SegmentType::ACTION) continue;
+                for (const std::string& name : this->options.forbidden_names) {
+                        if (segment.content.find(name) != std::string::npos) return false;
+                }
+
+                FlowType type = segment.directive.type;
+                if (type == FlowType::NONE) {
+                        if (this->options.arguments_only && !segment.content.starts_with("ARGS[")) return false;
+                        continue;
+                }
+                if (segment.directive.is_conditional()) {
+                        if (this->options.arguments_only) return false;
+                        continue;
+                }
+                if (type != FlowType::EXECUTE_MACRO) return false;
+
+                std::string_view call = segment.directive.arguments(segment.content);
+                std::size_t space = call.find(' ');
+                if (this->options.arguments_only && space != std::string_view::npos && !literal_arguments(call.substr(space + 1))) return false;
+                if (!is_pure(std::string(call.substr(0, space)))) return false;
+        }
+        return true;
+}
+
+void MacroClassifier::clear() {
+        this->known.clear();
+}
+
+bool MacroClassifier::literal_arguments(std::string_view arguments) {
+        while (!arguments.empty()) {
+                std::size_t end;
+                if (arguments.starts_with('"')) {
+                        end = arguments.find('"', 1);
+                        if (end == std::string_view::npos) return false;
+                        end++;
+                } else {
+                        end = std::min(arguments.find(' '), arguments.size());
+                        std::string_view argument = arguments.substr(0, end);
+                        if (!argument.starts_with("ARGS[") || argument.ends_with("#")) return false;
+                }
+                arguments.remove_prefix(end);
+                arguments.remove_prefix(std::min(arguments.find_first_not_of(' '), arguments.size()));
+        }
+        return true;
+}
+
+}
@@ -90,11 +90,12 @@ void Metaprocessor::explain() {
                               "Rules can be used to control how variables are handled, how files are processed, and more.\n\n"
                               "You can define rules in the settings file or pass them as command line arguments using the -r or --rule option.\n"
                               "Rules can be used to set default values for variables, control debugging levels, and more."
-                              "The rules are: strict_variables, set_default_variables, trim_start, trim_end, allow_env, allow_env_fallback, debug_level, max_variable_length, default_variable_value, variable_prefix, variable_suffix, include_path, benchmark\n";
+                              "The rules are: strict_variables, set_default_variables, trim_start, trim_end, allow_env, allow_env_fallback, debug_level, max_variable_length, default_variable_value, variable_prefix, variable_suffix, include_path, benchmark, batch_threads, parallel_threads, max_output_size, max_loop_iterations, max_include_depth, max_macro_depth, render_timeout_ms, skip_unchanged_output, macro_cache_size\n";
 
         } else if (input == "ignore") {
                 explanation = "Ignore in Prebyte is a feature that allows you to exclude certain variables, even if they are defined in the settings file or passed as command line arguments.\n"
-                              "You can define ignore patterns in the settings file or pass them as command line arguments using the -i or --ignore option.\n\n";
+                              "You can define ignore patterns in the settings file or pass them as command line arguments using the -i or --ignore option.\n"
+                              "A pattern is either a plain name or a glob, where '*' matches any sequence and '?' a single character, e.g. 'debug_*' or '*.secret'.\n\n";
         } else if (input == "profile") {
                 explanation = "A Profile in Prebyte is a set of rules, variables and ignores that can be applied to a specific context.\n"
                               "You can define profiles in the settings file, which can include variables, rules, and ignores.\n\n"
@@ -121,6 +122,7 @@ void Metaprocessor::explain() {
                 explanation = "The allow_env rule allows you to use environment variables in your Prebyte processing.\n"
                               "If allow_env is enabled, you can access environment variables using the variable prefix and suffix defined in the rules and also an $ before the environment variable that should be accessed.\n"
                               "This can be useful to access system-level variables or configuration values that are set in the environment.\n"
+                              "The environment is read once, at the first environment lookup of a render, so every reference in that render sees the same values.\n"
                               "If allow_env is disabled, environment variables will not be accessible in the processing.";
         } else if (input == "allow_env_fallback") {
                 explanation = "The allow_env_fallback rule allows you to use environment variables as a fallback if a variable is not defined.\n"
@@ -153,15 +155,63 @@ void Metaprocessor::explain() {
                               "You can change the variable suffix to any string you prefer, allowing you to customize how variables are accessed in your processing.\n"
                               "For example, if the suffix is set to '_var', you would access a variable named 'example' as %%example_var.";
         } else if (input == "include_path") {
-                explanation = "The include_path sets the path where Prebyte will look for unfound include Files.\n"
+                explanation = "The include_path sets the paths where Prebyte will look for unfound include Files.\n"
                               "This can be useful to specify a directory where additional files are stored to be included by calling the include command.\n"
                               "You can set the include_path in the rules, and it will be used to resolve include files that are not found in the current working directory or full path.\n"
+                              "Several directories can be given separated by ':', e.g. ./includes:~/.prebyte/includes. They are searched in that order.\n"
                               "By default, the include_path is set to ~/.prebyte/includes. This is recommended to be used for user-specific includes, because in future support a package manager to install usefull include files like an include where an macro is defined and includes all files given to the macro arguments.\n";
         } else if (input == "benchmark") {
                 explanation = "The benchmark rule allows you to enable benchmarking features in Prebyte.\n"
                               "You can choose to benchmark time, memory, or both during processing.\n"
                               "This can be useful to analyze the performance of your Prebyte scripts and identify potential bottlenecks.\n"
                               "The available options are: NONE, TIME, MEMORY, ALL.";
+        } else if (input == "batch_threads") {
+                explanation = "The batch_threads rule sets how many rows are rendered in parallel when using --rows.\n"
+                              "By default, batch_threads is set to 1, so all rows are rendered one after another.\n"
+                              "Set it to 0 to use one thread per available CPU core.\n"
+                              "The output is always written in the order of the rows, regardless of the number of threads.";
+        } else if (input == "parallel_threads") {
+                explanation = "The parallel_threads rule splits a single large input into chunks and renders them in parallel.\n"
+                              "By default, parallel_threads is set to 1, so the input is rendered on one thread. Set it to 0 to use one thread per available CPU core.\n"
+                              "The input is only split between top-level blocks, never inside an if, for or define block.\n"
+                              "Everything up to the last directive that changes state (set, unset, define, include, profiles and ignores) is rendered first, one after another;\n"
+                              "the chunks after it are rendered in parallel and written in input order. If no such split is possible, the input is rendered on one thread.";
+        } else if (input == "max_output_size" || input == "max_loop_iterations" || input == "render_timeout_ms") {
+                explanation = "The max_output_size, max_loop_iterations and render_timeout_ms rules set a budget for a single render.\n"
+                              "max_output_size limits the output in bytes, max_loop_iterations the total number of for loop iterations and render_timeout_ms the wall time in milliseconds.\n"
+                              "If a render exceeds its budget, processing stops with an error. With --rows, every row is a render of its own.\n"
+                              "By default, all three are set to 0, which means unlimited.";
+        } else if (input == "skip_unchanged_output") {
+                explanation = "The skip_unchanged_output rule keeps an output file untouched if the new output is identical to its content.\n"
+                              "Output files are always written to a temporary file first and renamed over the target, so readers never see a half-written file.\n"
+                              "If skip_unchanged_output is enabled, the existing file is compared first (its size, then its content) and not replaced when nothing changed,\n"
+                              "so its modification time stays the same and build tools do not rebuild what depends on it. By default, skip_unchanged_output is disabled.";
+        } else if (input == "macro_cache_size") {
+                explanation = "The macro_cache_size rule sets how many results of pure macro calls are remembered during a render.\n"
+                              "A macro is pure if its body only uses its arguments (ARGS) and calls other pure macros, or if it is defined with: %%define macro MacroName pure%%\n"
+                              "A pure macro called again with the same arguments is not rendered again; its earlier output is reused. When the cache is full, the least recently used result is dropped.\n"
+                              "The cache is cleared whenever a rule, ignore or profile changes. By default, macro_cache_size is set to 1024. Set it to 0 to render every call.";
+        } else if (input == "max_include_depth" || input == "max_macro_depth") {
+                explanation = "The max_include_depth and max_macro_depth rules limit how deeply includes and macro calls may be nested.\n"
+                              "Every include inside an included file, or macro call inside a macro, adds a level. If a limit is exceeded, processing stops with an error.\n"
+                              "Includes and macro calls do not use the native stack, but a for loop renders its body with a nested call. An include or macro call inside a loop body\n"
+                              "therefore uses native stack for every level, so raise these limits carefully if included files or macros contain loops.\n"
+                              "By default, both are set to 1024.";
+        } else if (input == "rows") {
+                explanation = "Rows in Prebyte allow you to render the same input once for every entry of a row source.\n"
+                              "A row source is a file that contains a list of variable sets, for example a CSV file or a JSON array of objects.\n\n"
+                              "Each row is rendered with the variables of the row on top of the normal variables. The index of the row is available as ROW_INDEX.\n"
+                              "The input is only read and scanned once, so rendering thousands of rows is much faster than calling prebyte once per row.\n"
+                              "You can specify the row source using the --rows <file> option.\n"
+                              "By default, all rendered rows are written one after another. With --rows-output <pattern> every row is written to its own file.\n"
+                              "The pattern is rendered like the input, so for example --rows-output 'out/%%name%%.txt' writes one file per name.";
+        } else if (input == "specialize") {
+                explanation = "Specializing in Prebyte turns an input into a smaller template for variables that never change in a deployment.\n"
+                              "With --specialize, the input is not rendered. Instead, references to constant variables are replaced by their values,\n"
+                              "conditions that only depend on constants are resolved and loops over constant arrays are unrolled. Everything else is kept.\n"
+                              "Rendering the result with the same settings gives the same output as rendering the input, but with less work per render.\n\n"
+                              "By default, every variable defined on the command line or in the settings is constant. With --constant <name> only the given variables are.\n"
+                              "A variable that is set or unset in the input is not constant from there on. Rules, profiles, ignores and includes stop specializing for the rest of the input.";
         } else if (input == "help") {
                 explanation = "The help command provides information about how to use Prebyte and its commands.\n"
                               "You can use it to get a list of available commands and their usage.\n\n"
@@ -203,14 +253,16 @@ void Metaprocessor::explain() {
                               "By default, the body of the profile is parsed as YAML, but you can specify a different parser type by adding it after the profile name.\n"
                               "For example, to define a profile with YAML parser, you would use: %%define profile my_profile yaml%%\n"
                               "Supported parsers are: yaml, json, toml.\n";
-        } else if (input == "include") {
+        } else if (input == "include" || input == "include_once") {
                 explanation = "The include command in Prebyte is used to include external files into the processing.\n"
                               "You start with your prefix and write 'include' followed by the file path.\n"
                               "For example, to include a file, you would use: %%include path/to/file%%\n"
                               "This will read the contents of the specified file and include it in the processing on the current position.\n"
                               "If no path is specified, it will look for the file in the current working directory.\n"
-                              "If the file is not found in the current working directory, it will look for it in the include_path specified in the rules.\n"
-                              "You can add additional Files in the default include path, so you can reuse them.\n";
+                              "If the file is not found in the current working directory, it will look for it in the directories of the include_path specified in the rules.\n"
+                              "You can add additional Files in the default include path, so you can reuse them.\n"
+                              "Use include_once instead of include to skip a file whose content was already included in the same run, e.g. %%include_once header.txt%%\n"
+                              "Files with identical content count as the same file.\n";
         } else if (input == "for" || input == "foreach" || input == "loop") {
                 explanation = "The for command in Prebyte is used to iterate over a collection of items, such as an array or a list of variables.\n"
                               "You start with your prefix and write 'for' followed by the variable name and the collection to iterate over.\n"
@@ -218,7 +270,13 @@ void Metaprocessor::explain() {
                               "This will execute the body of the loop for each item in the collection, allowing you to perform operations on each item.\n"
                               "To end the loop, you use the 'endfor' command: %%endfor%%. This will mark the end of the loop body, not as an break statement.\n"
                               "This for loop will copy the array, to ensure that the original array is not modified during the loop.\n"
-                              "The loop variable is reassigned during each iteration and remains defined after the loop.\n";
+                              "The loop variable is reassigned during each iteration and remains defined after the loop.\n\n"
+                              "You can also iterate over the rows of a CSV file by giving the file name in quotes: %%for row in \"data.csv\"%%\n"
+                              "The file is read row by row, so it can be larger than the available memory. The first line holds the column names.\n"
+                              "Each column is available as row.<column>, for example %%row.name%%, and row[0], row[1], ... hold the fields of the row.\n"
+                              "JSON arrays (.json) and JSON Lines files (.jsonl, .ndjson) are streamed the same way, one element at a time.\n"
+                              "For XML files (.xml) every child element of the root is one element; attributes are available as row.@<name>.\n"
+                              "Object members are available as row.<key>, nested objects as row.<key>.<key>.\n";
         } else if (input == "endfor") {
                 explanation = "The endfor command in Prebyte is used to mark the end of a for loop.\n"
                               "You start with your prefix and write 'endfor'.\n"
@@ -257,7 +315,8 @@ void Metaprocessor::explain() {
                               "For example, to define a macro, you would use: %%define macro MacroName%%\n"
                               "The body of the macro is defined in the following lines until an 'enddef' command encounters.\n"
                               "Macros can accept arguments, which are passed as an array called ARGS when the macro is called.\n"
-                              "You can call a macro using: %%exec MacroName \"First Argument\" Variable_As_Argument%%.";
+                              "You can call a macro using: %%exec MacroName \"First Argument\" Variable_As_Argument%%.\n"
+                              "Write 'pure' after the name (%%define macro MacroName pure%%) if the output only depends on the arguments; calls with the same arguments are then rendered once (see macro_cache_size).";
         } else if (input == "exec") {
                 explanation = "The exec command in Prebyte is used to call a previously defined macro.\n"
                               "You start with your prefix and write 'exec' followed by the macro name and any arguments you want to pass.\n"
@@ -314,6 +373,10 @@ std::cout << "   Usage: prebyte <command> [options]\n\n"
          << "\t-lsr, --list-rules      List used rules\n"
          << "\t-lsv, --list-variables  List used variables\n"
          << "\t-s, --settings <file>   Specify a settings file to use\n"
+         << "\t--rows <file>           Render the input once for every row of the given file (CSV, JSON, YAML, ...)\n"
+         << "\t--rows-output <pattern> Write every row to its own file. The pattern may contain variables\n"
+         << "\t--specialize            Write the input with constant variables folded in instead of rendering it\n"
+         << "\t--constant <name>       Only treat the given variable as constant with --specialize\n"
          << "\n"
          << "   Available options:\n"
          << "\t-r, --rule <rule>       Set a rule to be used during processing. <rule> is an KEY=VALUE pair\n"
@@ -338,7 +401,16 @@ std::cout << "   Usage: prebyte <command> [options]\n\n"
          << "\tvariable_prefix         Set the prefix used to identify variables\n"
          << "\tvariable_suffix         Set the suffix used to identify variables\n"
          << "\tinclude_path            Set the path where Prebyte will look for include files\n"
-         << "\tbenchmark               Enable benchmarking features (NONE, TIME, MEMORY, ALL)\n";
+         << "\tbenchmark               Enable benchmarking features (NONE, TIME, MEMORY, ALL)\n"
+         << "\tbatch_threads           Number of rows rendered in parallel with --rows (0 = all cores)\n"
+         << "\tparallel_threads        Number of threads rendering chunks of one input (1 = off, 0 = all cores)\n"
+         << "\tmax_output_size         Maximum output size of a render in bytes (0 = unlimited)\n"
+         << "\tmax_loop_iterations     Maximum for loop iterations of a render (0 = unlimited)\n"
+         << "\tmax_include_depth       Maximum nesting of includes (default 1024)\n"
+         << "\tmax_macro_depth         Maximum nesting of macro calls (default 1024)\n"
+         << "\trender_timeout_ms       Wall-time budget of a render in milliseconds (0 = unlimited)\n"
+         << "\tskip_unchanged_output   Do not rewrite output files whose content did not change\n"
+         << "\tmacro_cache_size        Results of pure macro calls kept per render (0 = off)\n";
 }
 
 void Metaprocessor::hard_help() {
@@ -380,12 +452,28 @@ void Metaprocessor::list_rules() {
         rules_list += "default_variable_value: " + context->rules.default_variable_value.value() + "\n";
         rules_list += "variable_prefix: " + context->rules.variable_prefix.value() + "\n";
         rules_list += "variable_suffix: " + context->rules.variable_suffix.value() + "\n";
-        rules_list += "include_path: " + context->rules.include_path.value() + "\n";
+        rules_list += "include_path: ";
+        std::vector<std::filesystem::path> include_dirs = context->rules.get_include_dirs();
+        for (std::size_t i = 0; i < include_dirs.size(); ++i) {
+                if (i > 0) rules_list += ":";
+                rules_list += include_dirs[i].string();
+        }
+        rules_list += "\n";
         rules_list += "benchmark: ";
         rules_list += (context->rules.benchmark.value() == Benchmark::NONE ? "None"
                             : context->rules.benchmark.value() == Benchmark::TIME ? "Time"
                             : context->rules.benchmark.value() == Benchmark::MEMORY ? "Memory"
                             : "All");
+        rules_list += "\n";
+        rules_list += "batch_threads: " + std::to_string(context->rules.batch_threads.value()) + "\n";
+        rules_list += "parallel_threads: " + std::to_string(context->rules.parallel_threads.value()) + "\n";
+        rules_list += "max_output_size: " + std::to_string(context->rules.max_output_size.value()) + "\n";
+        rules_list += "max_loop_iterations: " + std::to_string(context->rules.max_loop_iterations.value()) + "\n";
+        rules_list += "max_include_depth: " + std::to_string(context->rules.max_include_depth.value()) + "\n";
+        rules_list += "max_macro_depth: " + std::to_string(context->rules.max_macro_depth.value()) + "\n";
+        rules_list += "render_timeout_ms: " + std::to_string(context->rules.render_timeout_ms.value()) + "\n";
+        rules_list += "skip_unchanged_output: " + std::string(context->rules.skip_unchanged_output.value() ? "true" : "false") + "\n";
+        rules_list += "macro_cache_size: " + std::to_string(context->rules.macro_cache_size.value()) + "\n";
 
         std::string rules_debug_list = "Used Rules:  " + rules_list;
         std::replace(rules_debug_list.begin(), rules_debug_list.end(), '\n', ' ');
@@ -0,0 +1,156 @@
+#include "processor/ParallelPlan.h"
+
+#include <algorithm>
+#include <set>
+#include <string_view>
+
+#include "processor/MacroClassifier.h"
+
+namespace prebyte {
+
+namespace {
+
+/** Directives whose effect outlives their own block. */
+bool changes_state(FlowType type) {
+        switch (type) {
+                case FlowType::SET_VAR:
+                case FlowType::UNSET_VAR:
+                case FlowType::SET_RULE:
+                case FlowType::DEFINE_PROFILE:
+                case FlowType::SET_PROFILE:
+                case FlowType::UNSET_PROFILE:
+                case FlowType::SET_IGNORE:
+                case FlowType::UNSET_IGNORE:
+                case FlowType::DEFINE_MACRO:
+                case FlowType::INCLUDE:
+                case FlowType::INCLUDE_ONCE:
+                        return true;
+                default:
+                        return false;
+        }
+}
+
+int depth_change(FlowType type) {
+        switch (type) {
+                case FlowType::IF:
+                case FlowType::FOR:
+                case FlowType::DEFINE_MACRO:
+                case FlowType::DEFINE_PROFILE:
+                        return 1;
+                case FlowType::ENDIF:
+                case FlowType::ENDFOR:
+                case FlowType::END_DEFINE:
+                        return -1;
+                default:
+                        return 0;
+        }
+}
+
+std::string macro_name(const Segment& segment) {
+        std::string_view arguments = segment.directive.arguments(segment.content);
+        return std::string(arguments.substr(0, arguments.find(' ')));
+}
+
+}
+
+ParallelPlan ParallelPlan::make(const Template& compiled, std::size_t chunk_bytes) {
+        struct OpenLoop {
+                std::size_t depth;
+                std::string variable;
+                std::string array;  // Empty unless a top-level loop over an array.
+        };
+        struct Boundary {
+                std::size_t index;
+                std::size_t bytes;
+        };
+
+        const std::vector<Segment>& segments = compiled.get_segments();
+        std::vector<Boundary> boundaries{{0, 0}};
+        std::vector<OpenLoop> open_loops;
+        std::vector<std::pair<std::size_t, OpenLoop>> top_loops;    // End index and loop.
+        std::set<std::string> leaked;                               // Loop variables with an unknown value after their loop.
+        std::vector<std::pair<std::size_t, std::string>> calls;     // Index and name of macro calls.
+        std::size_t sequential_until = 0;
+        std::size_t depth = 0;
+        std::size_t bytes = 0;
+
+        for (std::size_t i = 0; i < segments.size(); ++i) {
+                const Segment& segment = segments[i];
+                bytes += segment.content.size();
+                if (segment.unterminated) return ParallelPlan();
+                if (segment.type == SegmentType::ACTION) {
+                        FlowType type = segment.directive.type;
+                        if (changes_state(type)) sequential_until = i + 1;
+                        for (const std::string& variable : leaked) {
+                                bool rebound = std::any_of(open_loops.begin(), open_loops.end(),
+                                                           [&variable](const OpenLoop& loop) { return loop.variable == variable; });
+                                if (!rebound && segment.content.find(variable) != std::string::npos) sequential_until = i + 1;
+                        }
+
+                        if (type == FlowType::FOR) {
+                                std::string_view arguments = segment.directive.arguments(segment.content);
+                                OpenLoop loop{depth, std::string(arguments.substr(0, arguments.find(' '))), {}};
+                                if (depth == 0 && !arguments.ends_with('"')) {
+                                        loop.array = std::string(arguments.substr(arguments.find_last_of(' ') + 1));
+                                }
+                                open_loops.push_back(std::move(loop));
+                        } else if (type == FlowType::ENDFOR && !open_loops.empty() && open_loops.back().depth + 1 == depth) {
+                                OpenLoop loop = std::move(open_loops.back());
+                                open_loops.pop_back();
+                                if (!loop.array.empty()) {
+                                        top_loops.emplace_back(i + 1, std::move(loop));
+                                } else {
+                                        leaked.insert(std::move(loop.variable));
+                                }
+                        } else if (type == FlowType::EXECUTE_MACRO) {
+                                calls.emplace_back(i, macro_name(segment));
+                        }
+
+                        int change = depth_change(type);
+                        if (change < 0 && depth == 0) return ParallelPlan();
+                        depth += change;
+                }
+                if (depth == 0) boundaries.push_back({i + 1, bytes});
+        }
+
+        ParallelPlan plan;
+        plan.leaked_variables.assign(leaked.begin(), leaked.end());
+        auto first = std::find_if(boundaries.begin(), boundaries.end(),
+                                  [sequential_until](const Boundary& boundary) { return boundary.index >= sequential_until; });
+        if (first == boundaries.end()) return plan;
+        plan.chunk_starts.push_back(first->index);
+        std::size_t chunk_begin = first->bytes;
+        for (auto boundary = first + 1; boundary != boundaries.end() && boundary->index < segments.size(); ++boundary) {
+                if (boundary->bytes - chunk_begin >= chunk_bytes) {
+                        plan.chunk_starts.push_back(boundary->index);
+                        chunk_begin = boundary->bytes;
+                }
+        }
+
+        auto chunk_of = [&plan](std::size_t index) {
+                return static_cast<std::size_t>(std::upper_bound(plan.chunk_starts.begin(), plan.chunk_starts.end(), index) - plan.chunk_starts.begin()) - 1;
+        };
+        for (auto& [end, loop] : top_loops) {
+                if (end > plan.chunk_starts.front()) {
+                        plan.loop_bindings.push_back({chunk_of(end - 1), std::move(loop.variable), std::move(loop.array)});
+                }
+        }
+        for (auto& [index, name] : calls) {
+                if (index >= plan.chunk_starts.front()) plan.macro_calls.push_back(std::move(name));
+        }
+        std::sort(plan.macro_calls.begin(), plan.macro_calls.end());
+        plan.macro_calls.erase(std::unique(plan.macro_calls.begin(), plan.macro_calls.end()), plan.macro_calls.end());
+        return plan;
+}
+
+bool ParallelPlan::macros_are_pure(const std::map<std::string, std::string>& macros, const std::string& prefix, const std::string& suffix) const {
+        MacroClassifier classifier({.forbidden_names = this->leaked_variables}, [&](const std::string& name) -> std::shared_ptr<const Template> {
+                auto macro = macros.find(name);
+                if (macro == macros.end()) return nullptr;
+                return std::make_shared<const Template>(Template::compile(macro->second, prefix, suffix));
+        });
+        return std::all_of(this->macro_calls.begin(), this->macro_calls.end(),
+                           [&classifier](const std::string& name) { return classifier.is_pure(name); });
+}
+
+}
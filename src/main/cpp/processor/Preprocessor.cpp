@@ -1,13 +1,29 @@
 #include "processor/Preprocessor.h"
 
+#include <thread>
+
+#include "processor/OrderedWorkers.h"
+
 namespace prebyte {
 
 
-Preprocessor::Preprocessor(std::unique_ptr<Context> context) : Processor(), process_variables(context.get()), process_flow(context.get()) {
+Preprocessor::Preprocessor(std::unique_ptr<Context> context) : Processor(), process_variables(context.get()), process_flow(context.get()),
+    macro_purity({.arguments_only = true, .declared_pure = &context->pure_macros}, [this](const std::string& macro_name) {
+            return this->context->macros.contains(macro_name) ? get_compiled_macro(macro_name) : nullptr;
+    }) {
     this->context = std::move(context);
 }
 
 void Preprocessor::process() {
+        this->context->memory_stats = MemoryStats();
+        // Counting every operator new costs time, so the CLI only does it for a memory
+        // benchmark. Without it the scope only sees arena blocks, which the API always reports.
+        Benchmark benchmark = this->context->rules.benchmark.value_or(Benchmark::NONE);
+        std::optional<MemoryScope> memory_scope;
+        if (benchmark == Benchmark::MEMORY || benchmark == Benchmark::ALL || !MemoryScope::counts_operator_new()) {
+                this->context->memory_stats.complete = MemoryScope::counts_operator_new();
+                memory_scope.emplace(this->context->memory_stats);
+        }
         this->context->logger->info("Starting preprocessing...");
         this->input = get_input();
         if (input.empty()) {
@@ -15,103 +31,49 @@ void Preprocessor::process() {
                 return;
         }
 
-        this->output = this->process_all(this->input);
+        if (this->context->output_sink) {
+                this->context->logger->debug("Streaming output into the provided output sink");
+        }
+        std::size_t threads = get_parallel_threads();
+        if (threads > 1) {
+                this->output = this->process_parallel(this->input, threads);
+        } else {
+                this->output = this->process_all(this->input);
+        }
 
         this->make_output();
+        this->context->memory_stats.retained_bytes = retained_bytes();
         this->make_benchmark();
 }
 
-std::string Preprocessor::get_input() const {
-    std::string input_data;
-    this->context->logger->debug("Getting input for action type: " + std::to_string(static_cast<int>(context->action_type)));
-
-    switch (context->action_type) {
-        case ActionType::FILE_IN_FILE_OUT:
-        case ActionType::FILE_IN_API_OUT:
-        case ActionType::FILE_IN_STDOUT: {
-            std::filesystem::path input_path = context->inputs[0];
-            std::ifstream input_file(input_path);
-            if (!input_file) {
-                this->context->logger->error("Error opening input file: " + input_path.string());
-                end(this->context.get());
-            }
-
-            this->context->logger->debug("Reading input from file: " + input_path.string());
-
-            input_data.assign(
-                std::istreambuf_iterator<char>(input_file),
-                std::istreambuf_iterator<char>()
-            );
-
-            if (input_data.empty()) {
-                this->context->logger->warn("Input file is empty.");
-                return "";
-            }
-
-            this->context->logger->debug("Input file read successfully.");
-            break;
+std::size_t Preprocessor::retained_bytes() {
+        std::size_t bytes = IncludeStore::shared().retained_bytes();
+        for (const auto& [name, compiled] : this->compiled_macros) {
+                bytes += compiled->memory_usage();
         }
-
-        case ActionType::STDIN_FILE_OUT:
-        case ActionType::STDIN_STDOUT: {
-            std::ostringstream ss;
-            ss << std::cin.rdbuf();
-            input_data = ss.str();
-
-            if (input_data.empty()) {
-                this->context->logger->warn("No input provided on stdin.");
-                return "";
-            }
-            break;
+        for (const auto& [included, compiled] : this->compiled_includes) {
+                bytes += compiled->memory_usage();
         }
-
-        case ActionType::API_IN_FILE_OUT:
-        case ActionType::API_IN_API_OUT: {
-                if (context->input.empty()) {
-                        this->context->logger->warn("No input provided for API action.");
-                        return "";
-                }
-                this->context->logger->debug("Using provided input for API action.");
-                return context->input;
+        if (this->environment) {
+                bytes += this->environment->memory_usage();
         }
-        default:
-            this->context->logger->error("Unknown action type for input: " + std::to_string(static_cast<int>(context->action_type)));
-            end(this->context.get());
-    }
-
-    return input_data;
+        return bytes;
 }
 
-void Preprocessor::make_output() const {
+void Preprocessor::make_output() {
         if (this->output.empty()) {
                 this->context->logger->debug("Output is empty, nothing to write.");
                 return;
         }
         this->context->logger->debug("Writing output for action type: " + std::to_string(static_cast<int>(context->action_type)));
         switch (context->action_type) {
-                case ActionType::FILE_IN_FILE_OUT: {
-                        std::filesystem::path output_path = context->inputs[1];
-                        std::ofstream output_file(output_path);
-                        if (!output_file) {
-                                this->context->logger->error("Error opening output file: " + output_path.string());
-                                end(this->context.get());
-                        }
-                        this->context->logger->debug("Writing output to file: " + output_path.string());
-                        output_file << output;
+                case ActionType::FILE_IN_FILE_OUT:
+                        write_output_file(context->inputs[1]);
                         break;
-                }
                 case ActionType::API_IN_FILE_OUT:
-                case ActionType::STDIN_FILE_OUT: {
-                        std::filesystem::path output_path = context->inputs[0];
-                        std::ofstream output_file(output_path);
-                        if (!output_file) {
-                                this->context->logger->error("Error opening output file: " + output_path.string());
-                                end(this->context.get());
-                        }
-                        this->context->logger->debug("Writing output to file: " + output_path.string());
-                        output_file << output;
+                case ActionType::STDIN_FILE_OUT:
+                        write_output_file(context->inputs[0]);
                         break;
-                }
                 case ActionType::FILE_IN_STDOUT:
                 case ActionType::STDIN_STDOUT:
                         this->context->logger->debug("Writing output to stdout.");
@@ -119,56 +81,293 @@ void Preprocessor::make_output() const {
                         break;
                 case ActionType::API_IN_API_OUT:
                 case ActionType::FILE_IN_API_OUT:
-                        this->context->output = output;
+                        this->context->logger->debug("Handing output back to the API.");
+                        this->context->output = std::move(this->output);
+                        break;
+                case ActionType::API_IN_SINK_OUT:
+                case ActionType::FILE_IN_SINK_OUT:
+                        this->context->logger->debug("Writing remaining output to the output sink.");
+                        if (!this->context->output_sink) {
+                                this->context->logger->error("No output sink provided for streaming output.");
+                                end(this->context.get());
+                        }
+                        this->context->output_sink(this->output);
+                        break;
                 default:
                         this->context->logger->error("Unknown action type for output: " + std::to_string(static_cast<int>(context->action_type)));
                         end(this->context.get());
         }
 }
 
-std::string Preprocessor::process_all(std::string input) {
-        int position = -1;
+void Preprocessor::write_output_file(const std::filesystem::path& output_path) {
+        this->context->logger->debug("Writing output to file: " + output_path.string());
+        try {
+                if (!OutputFile::write(output_path, this->output, this->context->rules.skip_unchanged_output.value_or(false))) {
+                        this->context->logger->debug("Output file is unchanged, keeping: " + output_path.string());
+                }
+        } catch (const std::exception& e) {
+                this->context->logger->error(e.what());
+                end(this->context.get());
+        }
+}
+
+std::string Preprocessor::process_all(const std::string& input) {
+        return process_all(compile(input));
+}
+
+std::string Preprocessor::process_all(const Template& compiled) {
+        std::string output;
+        process_all(compiled, output);
+        return output;
+}
+
+void Preprocessor::process_all(const Template& compiled, std::string& output) {
         this->context->logger->debug("processing new input");
-        std::string prefix = this->context->rules.variable_prefix.value();
-        std::string suffix = this->context->rules.variable_suffix.value();
-        std::string action_content = "";
-        std::string output = "";
-        while(!input.empty()) {
-                position = input.find_first_of(this->context->rules.variable_prefix.value());
-                if (position == std::string::npos) {
-                        this->context->logger->trace("Variable prefix not found in input, adding remaining input to output.");
-                        add_string(output,input);
-                        input.clear();
+        std::pmr::vector<Frame> frames(&this->pool);
+        frames.push_back(Frame{FrameKind::ROOT, nullptr, &compiled});
+        if (!this->sink_output) {
+                this->sink_output = &output;
+        }
+        auto output_of = [&frames, &output](const Frame& frame) -> std::string& {
+                return frame.writes_to == 0 ? output : frames[frame.writes_to].output;
+        };
+
+        // Delimiters can only change in an action, so they are checked after each
+        // action and after each finished frame.
+        auto recompile_if_needed = [this](Frame& frame) {
+                if (frame.current->matches(this->context->rules.variable_prefix.value(), this->context->rules.variable_suffix.value())) {
+                        return;
+                }
+                this->context->logger->debug("Variable prefix or suffix changed, compiling remaining input again");
+                frame.owned = std::make_shared<const Template>(compile(frame.current->source_from(frame.index)));
+                frame.current = frame.owned.get();
+                frame.index = 0;
+        };
+
+        while (true) {
+                Frame& frame = frames.back();
+                if (frame.index == frame.current->get_segments().size()) {
+                        if (frames.size() == 1) break;
+                        Frame finished = std::move(frame);
+                        frames.pop_back();
+                        leave_frame(finished);
+                        if (finished.writes_to == frames.size()) {
+                                add_string(output_of(frames.back()), finished.output);
+                        }
+                        recompile_if_needed(frames.back());
                         continue;
                 }
-                add_string(output,input.substr(0, position));
-                input.erase(0, position + this->context->rules.variable_prefix.value().length());
 
-                if (!input.empty() && input[0] == '#') {
-                        this->context->logger->debug("Found linewise action");
-                        position = input.find_first_of('\n');
-                        if (position == std::string::npos) {
-                                position = input.length();
+                const Segment& segment = frame.current->get_segments()[frame.index++];
+                if (segment.unterminated) {
+                        this->context->logger->error("Variable suffix not found in input.");
+                        end(this->context.get());
+                }
+                std::string& frame_output = output_of(frame);
+                if (segment.type == SegmentType::TEXT) {
+                        add_string(frame_output, segment.content);
+                        continue;
+                }
+                this->context->logger->debug("Found Action: {}", segment.content);
+                check_budget();
+                this->action_output = &frame_output;
+                add_string(frame_output, do_action(segment.content, segment.directive));
+
+                if (this->pending_frame) {
+                        // A cached macro call collects its own output; every other frame writes into its caller's.
+                        this->pending_frame->writes_to = this->pending_frame->cache_key.empty() ? frame.writes_to : frames.size();
+                        frames.push_back(std::move(*this->pending_frame));
+                        this->pending_frame.reset();
+                        continue;
+                }
+                recompile_if_needed(frame);
+        }
+
+        if (this->sink_output == &output) {
+                this->sink_output = nullptr;
+        }
+}
+
+std::string Preprocessor::process_parallel(const std::string& input, std::size_t threads) {
+        Template compiled = compile(input);
+        ParallelPlan plan = ParallelPlan::make(compiled, std::max(input.size() / (threads * 4), PARALLEL_CHUNK_SIZE));
+        if (!plan.parallel()) {
+                this->context->logger->debug("Input has no parallel chunks, rendering it on one thread");
+                return process_all(compiled);
+        }
+
+        std::vector<Template> parts = std::move(compiled).split(plan.chunk_starts);
+        this->context->logger->debug("Rendering {} segments sequentially before {} parallel chunks", plan.chunk_starts.front(), plan.chunk_starts.size());
+        std::string output = process_all(parts.front());
+        flush_to_sink(output);
+
+        const std::string& prefix = this->context->rules.variable_prefix.value();
+        const std::string& suffix = this->context->rules.variable_suffix.value();
+        if (!parts[1].matches(prefix, suffix) || !plan.macros_are_pure(this->context->macros, prefix, suffix)) {
+                this->context->logger->debug("Delimiters changed or a called macro changes state, rendering the rest on one thread");
+                std::string rest;
+                for (std::size_t i = 1; i < parts.size(); ++i) {
+                        rest += parts[i].source_from(0);
+                }
+                add_string(output, process_all(rest));
+                return output;
+        }
+
+        // Every chunk starts with the loop variables left behind by the top-level loops before it.
+        std::size_t chunk_count = plan.chunk_starts.size();
+        std::vector<std::map<std::string, std::string>> loop_values(chunk_count);
+        std::map<std::string, std::string> values;
+        auto binding = plan.loop_bindings.begin();
+        for (std::size_t chunk = 0; chunk < chunk_count; ++chunk) {
+                loop_values[chunk] = values;
+                for (; binding != plan.loop_bindings.end() && binding->chunk == chunk; ++binding) {
+                        if (auto bound = values.find(binding->array); bound != values.end()) {
+                                values[binding->variable] = bound->second;
+                        } else if (auto array = this->context->variables.find(binding->array);
+                                   array != this->context->variables.end() && !array->second.empty()) {
+                                values[binding->variable] = array->second.back();
                         }
-                        action_content = input.substr(1, position - 1);
-                        input.erase(0, position + 1);
-                } else {
-                        this->context->logger->debug("Found inline action");
-                        position = input.find_first_of(this->context->rules.variable_suffix.value());
-                        if (position == std::string::npos) {
-                                this->context->logger->error("Variable suffix not found in input.");
-                                end(this->context.get());
+                }
+        }
+
+        std::atomic<std::int64_t> iterations = this->loop_iterations;
+        auto render_chunk = [this, &parts, &loop_values, &iterations](std::size_t chunk, std::size_t) {
+                auto chunk_context = std::make_unique<Context>(*this->context);
+                chunk_context->output_sink = nullptr;
+                // Errors on a worker must not exit the process; they are rethrown below.
+                chunk_context->is_api = true;
+                for (const auto& [name, value] : loop_values[chunk]) {
+                        chunk_context->variables[name] = {value};
+                }
+                Preprocessor preprocessor(std::move(chunk_context));
+                preprocessor.render_start = this->render_start;
+                preprocessor.shared_loop_iterations = &iterations;
+                return preprocessor.render(parts[chunk + 1]);
+        };
+        std::size_t workers = std::min(threads, chunk_count);
+        try {
+                run_ordered(chunk_count, workers, render_chunk, [this, &output](std::size_t, std::string& chunk_output) {
+                        add_string(output, chunk_output);
+                        if (output.size() >= SINK_CHUNK_SIZE) {
+                                flush_to_sink(output);
                         }
-                        action_content = input.substr(0, position);
-                        input.erase(0, position + this->context->rules.variable_suffix.value().length());
+                });
+        } catch (const std::exception&) {
+                // All workers have stopped here, so the CLI can exit safely.
+                if (this->context->is_api) throw;
+                end(this->context.get());
+        }
+        if (workers > 1) {
+                // Memory scopes are per thread, so the allocations of the workers were not counted.
+                this->context->memory_stats.complete = false;
+        }
+        this->loop_iterations = iterations;
+        return output;
+}
+
+std::size_t Preprocessor::get_parallel_threads() const {
+        std::size_t threads = static_cast<std::size_t>(this->context->rules.parallel_threads.value_or(1));
+        if (threads == 0) {
+                threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        return threads;
+}
+
+void Preprocessor::enter_frame(Frame frame) {
+        if (frame.kind == FrameKind::INCLUDE) {
+                std::size_t max_depth = static_cast<std::size_t>(this->context->rules.max_include_depth.value_or(1024));
+                if (this->processed_includes.size() >= max_depth) {
+                        this->context->logger->error("Maximum include depth of {} exceeded at {}", max_depth, frame.include_path);
+                        end(this->context.get());
+                }
+        } else if (frame.kind == FrameKind::MACRO) {
+                std::size_t max_depth = static_cast<std::size_t>(this->context->rules.max_macro_depth.value_or(1024));
+                if (this->macro_args.size() > max_depth) {
+                        this->context->logger->error("Maximum macro depth of {} exceeded", max_depth);
+                        end(this->context.get());
+                }
+        }
+        this->pending_frame = std::move(frame);
+}
+
+void Preprocessor::check_budget() {
+        if (this->context->cancellation.is_cancelled()) {
+                this->context->logger->error("Render was cancelled");
+                end(this->context.get());
+        }
+        if ((++this->budget_checks & 63) != 0) return;
+        std::int64_t timeout = this->context->rules.render_timeout_ms.value_or(0);
+        if (timeout > 0 && std::chrono::steady_clock::now() - this->render_start > std::chrono::milliseconds(timeout)) {
+                this->context->logger->error("Render exceeded render_timeout_ms of {} ms", timeout);
+                end(this->context.get());
+        }
+}
+
+void Preprocessor::count_loop_iteration() {
+        std::int64_t max_iterations = this->context->rules.max_loop_iterations.value_or(0);
+        std::int64_t iterations = this->shared_loop_iterations ? ++*this->shared_loop_iterations : ++this->loop_iterations;
+        if (iterations > max_iterations && max_iterations > 0) {
+                this->context->logger->error("Render exceeded max_loop_iterations of {}", max_iterations);
+                end(this->context.get());
+        }
+        check_budget();
+}
+
+void Preprocessor::leave_frame(const Frame& frame) {
+        if (frame.kind == FrameKind::INCLUDE) {
+                this->context->logger->trace("Removing include path from including stack: " + frame.include_path);
+                this->active_includes.erase(frame.include_path);
+                this->processed_includes.pop_back();
+        } else if (frame.kind == FrameKind::MACRO) {
+                this->context->logger->trace("Popping macro arguments after execution");
+                this->macro_args.pop_back();
+                if (!frame.cache_key.empty()) {
+                        this->macro_cache.insert(frame.cache_key, frame.output);
                 }
-                this->context->logger->debug("Found Action: " + action_content);
-                add_string(output, do_action(action_content));
         }
-        
+}
+
+Template Preprocessor::compile(const std::string& input) {
+        return Template::compile(input, this->context->rules.variable_prefix.value(), this->context->rules.variable_suffix.value());
+}
+
+std::string Preprocessor::render(const Template& compiled) {
+        return process_all(compiled);
+}
+
+std::string Preprocessor::render(const Template& compiled, const std::map<std::string, std::vector<std::string>>& variables) {
+        this->ignore_next = false;
+        this->current_depth = 0;
+        this->branch_taken.clear();
+        this->ignore_depth = 0;
+        this->pipe = false;
+        this->for_stack = 0;
+        this->output.clear();
+        this->included_contents.clear();
+        this->loop_iterations = 0;
+        this->budget_checks = 0;
+        this->render_start = std::chrono::steady_clock::now();
+
+        this->bound_variables.emplace();
+        for (const auto& [name, values] : variables) {
+                bind_variable(name) = values;
+        }
+        std::string output = process_all(compiled);
+        for (auto& [name, previous] : *this->bound_variables) {
+                if (previous) {
+                        this->context->variables[name] = std::move(*previous);
+                } else {
+                        this->context->variables.erase(name);
+                }
+        }
+        this->bound_variables.reset();
         return output;
 }
 
+bool Preprocessor::changed_context() const {
+        return this->context_changed;
+}
+
 void Preprocessor::add_string(std::string& output, const std::string& str) {
         if (!this->ignore_next) {
                 if (this->pipe) {
@@ -177,21 +376,72 @@ void Preprocessor::add_string(std::string& output, const std::string& str) {
                 } else {
                         this->context->logger->trace("Adding string to output");
                         output += str;
+                        std::int64_t max_size = this->context->rules.max_output_size.value_or(0);
+                        if (max_size > 0 && output.size() + this->flushed_bytes > static_cast<std::size_t>(max_size)) {
+                                this->context->logger->error("Render output exceeds max_output_size of {} bytes", max_size);
+                                end(this->context.get());
+                        }
+                        if (&output == this->sink_output && output.size() >= SINK_CHUNK_SIZE) {
+                                flush_to_sink(output);
+                        }
                 }
         }
 }
 
+void Preprocessor::flush_to_sink(std::string& output) {
+        if (!this->context->output_sink) return;
+        this->context->logger->trace("Flushing {} bytes into the output sink", output.size());
+        this->context->output_sink(output);
+        this->flushed_bytes += output.size();
+        output.clear();
+}
+
 
 
-std::string Preprocessor::do_action(const std::string& action) {
-        this->context->logger->debug("Processing action: " + action);
-        std::string variable_name = get_variable_name(action);
-        if (context->ignore.find(action) != context->ignore.end()) {
-                this->context->logger->debug("Ignoring variable: " + action);
+std::shared_ptr<const IncludedFile> Preprocessor::get_included_file(const std::filesystem::path& include_path) {
+        auto it = this->included_files.find(include_path.string());
+        if (it != this->included_files.end()) {
+                return it->second;
+        }
+        try {
+                std::shared_ptr<const IncludedFile> included = IncludeStore::shared().load(include_path);
+                this->included_files.emplace(include_path.string(), included);
+                return included;
+        } catch (const std::exception& e) {
+                this->context->logger->error(e.what());
+                end(this->context.get());
+        }
+        return nullptr;
+}
+
+std::shared_ptr<const Template> Preprocessor::get_compiled_include(const std::shared_ptr<const IncludedFile>& included) {
+        auto it = this->compiled_includes.find(included.get());
+        if (it != this->compiled_includes.end() &&
+            it->second->matches(this->context->rules.variable_prefix.value(), this->context->rules.variable_suffix.value())) {
+                return it->second;
+        }
+        auto compiled = std::make_shared<const Template>(compile(included->content));
+        this->compiled_includes[included.get()] = compiled;
+        return compiled;
+}
+
+const Environment& Preprocessor::get_environment() {
+        if (!this->environment) {
+                this->context->logger->debug("Taking environment snapshot");
+                this->environment = Environment::capture();
+        }
+        return *this->environment;
+}
+
+std::string Preprocessor::do_action(const std::string& action, const Directive& directive) {
+        this->context->logger->debug("Processing action: {}", action);
+        std::string_view variable_name = get_variable_name_view(action);
+        if (context->ignore.matches(action)) {
+                this->context->logger->debug("Ignoring variable: {}", action);
                 return "";
         }
         if (process_variables.is_valid(action)) {
-                this->context->logger->debug("Processing: " + action);
+                this->context->logger->debug("Processing: {}", action);
                 return process_variables.get_value(action);
         }
 
@@ -210,99 +460,125 @@ std::string Preprocessor::do_action(const std::string& action) {
                         end(this->context.get());
                 }
 
-                std::vector<std::string> args = this->macro_args.top();
+                const std::pmr::vector<std::pmr::string>& args = this->macro_args.back();
                 int index = get_variable_number(action);
                 if (index < 0 || index >= args.size()) {
-                        this->context->logger->error("Index out of bounds for ARGS variable: " + variable_name);
+                        this->context->logger->error("Index out of bounds for ARGS variable: {}", variable_name);
                         end(this->context.get());
                 }
-                return args[index];
+                return std::string(args[index]);
         }
 
-        if (context->variables.find(variable_name) != context->variables.end()) {
-                this->context->logger->debug("Substituting variable: " + variable_name);
+        if (!(this->pipe && this->for_stack > 0) && context->variables.contains(std::string(variable_name))) {
+                this->context->logger->debug("Substituting variable: {}", variable_name);
                 return get_variable(action);
         }
 
-        if (process_flow.is_valid(action)) {
+        if (directive.type != FlowType::NONE) {
                 if (this->pipe) {
-                        this->context->logger->trace("Processing flow action in pipe mode: " + action);
-                        if (action.starts_with("for ")) {
-                                this->context->logger->trace("Processing 'for' action in pipe mode: " + action);
+                        this->context->logger->trace("Processing flow action in pipe mode: {}", action);
+                        if (directive.type == FlowType::FOR) {
+                                this->context->logger->trace("Processing 'for' action in pipe mode: {}", action);
                                 this->for_stack++;
                                 return this->context->rules.variable_prefix.value() + action + this->context->rules.variable_suffix.value();
-                        } else if (action == "endfor" && this->for_stack > 1) {
-                                this->context->logger->trace("Processing 'endfor' action in pipe mode: " + action);
+                        } else if (directive.type == FlowType::ENDFOR && this->for_stack > 1) {
+                                this->context->logger->trace("Processing 'endfor' action in pipe mode: {}", action);
                                 this->for_stack--;
                                 return this->context->rules.variable_prefix.value() + action + this->context->rules.variable_suffix.value();
-                        } else if (action.starts_with("include ")) {
-                                this->context->logger->trace("Processing 'include' action in pipe mode: " + action);
+                        } else if (this->for_stack > 0 && directive.is_conditional()) {
+                                this->context->logger->trace("Deferring conditional until loop iteration: {}", action);
+                                return this->context->rules.variable_prefix.value() + action + this->context->rules.variable_suffix.value();
+                        } else if (directive.type == FlowType::INCLUDE || directive.type == FlowType::INCLUDE_ONCE) {
+                                this->context->logger->trace("Processing 'include' action in pipe mode: {}", action);
                                 return this->context->rules.variable_prefix.value() + action + this->context->rules.variable_suffix.value();
                         }
                 }
-                return process_code_flow(action);
+                return process_code_flow(action, directive);
         }
 
         if (this->pipe) {
-                this->context->logger->trace("Processing action in pipe mode: " + action);
+                this->context->logger->trace("Processing action in pipe mode: {}", action);
                 return this->context->rules.variable_prefix.value() + action + this->context->rules.variable_suffix.value();
         }
 
         if (this->ignore_next) {
-                this->context->logger->debug("Ignoring action: " + action);
+                this->context->logger->debug("Ignoring action: {}", action);
                 return "";
         }
 
         if (context->rules.allow_env.value()) {
-                this->context->logger->debug("Checking environment variables for action: " + action);
+                const Environment& environment = get_environment();
                 if (action.starts_with("$")) {
-                        const char* env_value = std::getenv(action.substr(1).c_str());
-                        if (env_value) {
-                                this->context->logger->debug("Found environment variable: " + action + " with value: " + std::string(env_value));
-                                return std::string(env_value);
+                        if (const std::string* env_value = environment.find(std::string_view(action).substr(1))) {
+                                this->context->logger->debug("Found environment variable: {} with value: {}", action, *env_value);
+                                return *env_value;
                         }
                 }
-                this->context->logger->debug("No environment variable found for action: {}. Checking fallback.", action);
                 if (context->rules.allow_env_fallback.value()) {
-                        const char* env_value = std::getenv(action.c_str());
-                        if (env_value) {
-                                this->context->logger->debug("Found environment variable: " + action + " with value: " + std::string(env_value));
-                                return std::string(env_value);
+                        if (const std::string* env_value = environment.find(action)) {
+                                this->context->logger->debug("Found environment variable: {} with value: {}", action, *env_value);
+                                return *env_value;
                         }
-                        this->context->logger->debug("No environment variable found for action: " + action);
+                        this->context->logger->debug("No environment variable found for action: {}", action);
                 }
         }
 
         if (context->rules.set_default_variables.value()) {
-                this->context->logger->debug("Using default variable value for action: " + action);
+                this->context->logger->debug("Using default variable value for action: {}", action);
                 return get_variable(context->rules.default_variable_value.value());
         }
         if (!context->rules.strict_variables.value()) {
-                this->context->logger->debug("Variable '" + action + "' not found, returning as is.");
+                this->context->logger->debug("Variable '{}' not found, returning as is.", action);
                 return context->rules.variable_prefix.value() + action + context->rules.variable_suffix.value();
         } else {
-                this->context->logger->error("Variable '" + action + "' not found and strict variables are enabled.");
+                this->context->logger->error("Variable '{}' not found and strict variables are enabled.", action);
                 end(this->context.get());
         }
         return "";
 }
 
-std::string Preprocessor::process_code_flow(const std::string& action) {
-        if (process_flow.is_skipable(action, ignore_next)) {
+std::string Preprocessor::process_code_flow(const std::string& action, const Directive& directive) {
+        if (process_flow.is_skipable(directive, ignore_next)) {
                 this->context->logger->debug("Skipping action: " + action);
                 return "";
         }
 
-        std::string output = process_flow.get_value(action);
+        std::string output = process_flow.get_value(action, directive);
         FlowState this_state = process_flow.get_flow_state();
 
+        switch (directive.type) {
+                case FlowType::SET_RULE:
+                case FlowType::SET_PROFILE:
+                case FlowType::UNSET_PROFILE:
+                case FlowType::SET_IGNORE:
+                case FlowType::UNSET_IGNORE:
+                        // Rules, ignores and profiles change how macro bodies are rendered.
+                        this->context->logger->trace("Settings changed, dropping cached macro results");
+                        this->macro_cache.clear();
+                        this->macro_purity.clear();
+                        this->context_changed = true;
+                        break;
+                case FlowType::SET_VAR:
+                case FlowType::UNSET_VAR:
+                case FlowType::DEFINE_PROFILE:
+                case FlowType::END_DEFINE:
+                        this->context_changed = true;
+                        break;
+                default:
+                        break;
+        }
+
         this->context->logger->debug("Processing code flow action: {}", std::to_string(static_cast<int>(this_state)));
 
-        if (this_state == FlowState::INCLUDE) {
+        if (this_state == FlowState::INCLUDE || this_state == FlowState::INCLUDE_ONCE) {
+                if (output.empty()) {
+                        this->context->logger->error("Include file not found: " + std::string(directive.arguments(action)));
+                        end(this->context.get());
+                }
                 std::filesystem::path include_path = output;
                 this->context->logger->debug("Including file: " + include_path.string());
 
-                if (std::find(processed_includes.begin(), processed_includes.end(), include_path) != processed_includes.end()) {
+                if (this->active_includes.contains(include_path.string())) {
                         this->context->logger->error("Circular include detected for " + include_path.string());
                         if (this->context->logger->should_log(spdlog::level::trace)) {
                                 this->context->logger->trace("Processed includes:");
@@ -313,29 +589,30 @@ std::string Preprocessor::process_code_flow(const std::string& action) {
                         end(this->context.get());
                 }
 
+                std::shared_ptr<const IncludedFile> included = get_included_file(include_path);
+                if (this_state == FlowState::INCLUDE_ONCE && this->included_contents.contains(included.get())) {
+                        this->context->logger->debug("Skipping include_once of already included content: " + include_path.string());
+                        return "";
+                }
+                this->included_contents.insert(included.get());
+                std::shared_ptr<const Template> compiled = get_compiled_include(included);
+
+                Frame frame{FrameKind::INCLUDE, compiled, compiled.get()};
+                frame.include_path = include_path.string();
+                enter_frame(std::move(frame));
+
                 this->context->logger->trace("Adding include path to including stack: " + include_path.string());
+                this->active_includes.insert(include_path.string());
                 processed_includes.push_back(include_path);
 
-                std::ifstream include_file(include_path);
-                if (!include_file) {
-                        this->context->logger->error("Error opening include file: " + include_path.string());
-                        end(this->context.get());
-                }
-                std::string include_content(
-                    std::istreambuf_iterator<char>(include_file),
-                    std::istreambuf_iterator<char>{}
-                );
-
                 this->context->include_counter++;
                 this->context->logger->trace("Include depth: {}, total includes: {}", this->processed_includes.size(), this->context->include_counter);
                 this->context->logger->debug("Processing included file: " + include_path.string());
-                std::string result = process_all(include_content);
-                this->context->logger->trace("Removing include path from including stack: " + include_path.string());
-                processed_includes.pop_back();
-                return result;
+                return "";
         } else if (this_state == FlowState::IF) {
                 this->context->logger->debug("Processing 'if' condition: " + output);
                 this->current_depth++;
+                this->branch_taken.push_back(false);
                 if (!ignore_next) {
                         this->context->logger->debug("Evaluating if condition: " + output);
                         if (output == "false") {
@@ -344,15 +621,16 @@ std::string Preprocessor::process_code_flow(const std::string& action) {
                                 this->ignore_depth = this->current_depth;
                         } else {
                                 this->context->logger->debug("If condition evaluated to true, ignoring all subsequent conditions until 'endif'");
-                                this->ignore_all = this->current_depth;
+                                this->branch_taken.back() = true;
                         }
                         return "";
                 }
         } else if (this_state == FlowState::ELSE_IF) {
                 this->context->logger->debug("Processing 'elif' condition: " + output);
-                if (ignore_all) {
+                if (!this->branch_taken.empty() && this->branch_taken.back()) {
                         this->context->logger->debug("Ignoring elif condition, because there was a previous if/elif that was executed");
                         this->ignore_next = true;
+                        this->ignore_depth = this->current_depth;
                         return "";
                 }
                 if (this->current_depth == this->ignore_depth && this->ignore_next) {
@@ -367,15 +645,16 @@ std::string Preprocessor::process_code_flow(const std::string& action) {
                                 this->ignore_depth = this->current_depth;
                         } else {
                                 this->context->logger->debug("Elif condition evaluated to true, ignoring all subsequent conditions until 'endif'");
-                                this->ignore_all = this->current_depth;
+                                this->branch_taken.back() = true;
                         }
                         return "";
                 }
         } else if (this_state == FlowState::ELSE) {
                 this->context->logger->debug("Processing 'else' condition");
-                if (ignore_all) {
+                if (!this->branch_taken.empty() && this->branch_taken.back()) {
                         this->context->logger->debug("Ignoring else condition, because there was a previous if/elif that was executed");
                         this->ignore_next = true;
+                        this->ignore_depth = this->current_depth;
                         return "";
                 }
                 if (this->current_depth == this->ignore_depth && this->ignore_next) {
@@ -384,12 +663,12 @@ std::string Preprocessor::process_code_flow(const std::string& action) {
                 }
         } else if (this_state == FlowState::END_IF) {
                 this->context->logger->debug("Processing 'endif' condition");
-                this->current_depth--;
-                this->ignore_all = 0;
-                if (this->current_depth < 0) {
+                if (this->branch_taken.empty()) {
                         this->context->logger->error("Unmatched 'endif' in code flow.");
                         end(this->context.get());
                 }
+                this->branch_taken.pop_back();
+                this->current_depth--;
                 if (this->current_depth < this->ignore_depth) {
                         this->context->logger->debug("Resetting ignore_next flag, because current depth is less than ignore depth.");
                         this->ignore_next = false;
@@ -443,6 +722,7 @@ std::string Preprocessor::process_code_flow(const std::string& action) {
                 } else if (!this->macro_name.empty()) {
                         this->context->logger->debug("Ending macro definition for " + this->macro_name);
 
+                        bool pure = std::exchange(this->macro_pure, false);
                         if (context->macros.find(this->macro_name) != context->macros.end()) {
                                 this->context->logger->warn("Macro '" + this->macro_name + "' already defined.");
                                 return "";
@@ -450,6 +730,10 @@ std::string Preprocessor::process_code_flow(const std::string& action) {
 
                         this->context->logger->debug("Adding macro {}", this->macro_name);
                         context->macros[this->macro_name] = this->output;
+                        if (pure) {
+                                context->pure_macros.insert(this->macro_name);
+                        }
+                        this->macro_purity.clear();
                         this->context->logger->trace("Deleting macro name and output after definition");
                         this->macro_name.clear();
                         this->output.clear();
@@ -462,11 +746,19 @@ std::string Preprocessor::process_code_flow(const std::string& action) {
                 this->pipe = true;
                 this->output = "";
                 this->context->logger->debug("Defining new macro");
-                this->macro_name = output;
+                this->macro_name = output.substr(0, output.find(' '));
                 if (this->macro_name.empty()) {
                         this->context->logger->error("Macro name cannot be empty.");
                         end(this->context.get());
                 }
+                std::string annotation = output.find(' ') == std::string::npos ? "" : output.substr(output.find(' ') + 1);
+                if (annotation == "pure") {
+                        this->context->logger->debug("Macro is declared pure");
+                        this->macro_pure = true;
+                } else if (!annotation.empty()) {
+                        this->context->logger->error("Unknown macro annotation: " + annotation);
+                        end(this->context.get());
+                }
                 this->context->logger->debug("Macro name set to: " + this->macro_name);
                 return "";
         } else if (this_state == FlowState::EXECUTE_MACRO) {
@@ -478,20 +770,33 @@ std::string Preprocessor::process_code_flow(const std::string& action) {
                         end(this->context.get());
                 }
                 this->context->logger->debug("Executing macro: " + macro_name);
-                this->macro_args.push(get_variable_values(output));
+                std::pmr::vector<std::pmr::string> args = get_variable_values(output);
 
                 this->context->logger->trace("Processing macro with name: " + macro_name);
                 this->context->logger->trace("Macro arguments: ");
                 if (this->context->logger->should_log(spdlog::level::trace)) {
-                        for (const auto& arg : this->macro_args.top()) {
-                                this->context->logger->trace(" - " + arg);
+                        for (const auto& arg : args) {
+                                this->context->logger->trace(" - {}", arg);
+                        }
+                }
+
+                std::string cache_key;
+                int cache_size = this->context->rules.macro_cache_size.value_or(0);
+                if (!this->pipe && cache_size > 0 && this->macro_purity.is_pure(macro_name)) {
+                        this->macro_cache.set_capacity(static_cast<std::size_t>(cache_size));
+                        cache_key = MacroCache::key(macro_name, args);
+                        if (const std::string* cached = this->macro_cache.find(cache_key)) {
+                                this->context->logger->debug("Reusing output of pure macro: " + macro_name);
+                                return *cached;
                         }
                 }
-                std::string result = process_all(this->context->macros[macro_name]);
-                this->context->logger->trace("Popping macro arguments after execution");
-                this->macro_args.pop();
 
-                return result;
+                this->macro_args.push_back(std::move(args));
+                std::shared_ptr<const Template> macro = get_compiled_macro(macro_name);
+                Frame frame{FrameKind::MACRO, macro, macro.get()};
+                frame.cache_key = std::move(cache_key);
+                enter_frame(std::move(frame));
+                return "";
         } else if (this_state == FlowState::FOR) {
                 this->context->logger->debug("Processing 'for' loop: " + output);
                 this->for_stack++;
@@ -519,6 +824,21 @@ std::string Preprocessor::process_code_flow(const std::string& action) {
                                 end(this->context.get());
                         }
 
+                        if (for_array.ends_with("\"")) {
+                                std::string source = this->for_variable.substr(this->for_variable.find('"') + 1);
+                                source.pop_back();
+                                Template to_loop = compile(this->output);
+                                this->output.clear();
+                                this->for_variable.clear();
+                                std::filesystem::path source_path = source;
+                                if (source_path.extension() == ".json" || source_path.extension() == ".jsonl" || source_path.extension() == ".ndjson" || source_path.extension() == ".xml") {
+                                        process_element_loop(for_variable, source, to_loop, *this->action_output);
+                                } else {
+                                        process_csv_loop(for_variable, source, to_loop, *this->action_output);
+                                }
+                                return "";
+                        }
+
                         this->context->logger->trace("Trying to find array for for loop: " + for_array);
 
                         if (context->variables.find(for_array) == context->variables.end()) {
@@ -529,64 +849,187 @@ std::string Preprocessor::process_code_flow(const std::string& action) {
                         this->context->logger->debug("For loop variable: " + for_variable);
                         this->context->logger->debug("For loop array: " + for_array);
 
-                        std::vector<std::string> values = context->variables[for_array];
+                        // The loop body may reassign the array, so iterate over a copy.
+                        const std::vector<std::string>& array = context->variables[for_array];
+                        std::pmr::vector<std::pmr::string> values(array.begin(), array.end(), &this->pool);
                         if (values.empty()) {
                                 this->context->logger->debug("For loop array is empty, nothing to iterate over.");
                                 return "";
                         }
 
-                        std::string to_loop = this->output;
-                        std::string result;
+                        Template to_loop = compile(this->output);
+                        std::string& result = *this->action_output;
 
                         this->context->logger->debug("Processing for loop with " + std::to_string(values.size()) + " items.");
-                        for (const std::string value : values) {
-                                this->context->logger->trace("Processing for loop value: " + value);
-                                context->variables[for_variable] = {value};
-                                this->context->logger->trace("Substituting for loop variable: " + for_variable + " with value: " + value);
-                                result += process_all(to_loop);
+                        for (const std::pmr::string& value : values) {
+                                count_loop_iteration();
+                                this->context->logger->trace("Processing for loop value: {}", value);
+                                bind_variable(for_variable) = {std::string(value)};
+                                this->context->logger->trace("Substituting for loop variable: {} with value: {}", for_variable, value);
+                                process_all(to_loop, result);
                         }
 
                         this->context->logger->trace("For loop completed, resetting output and for_variable.");
                         this->output.clear();
                         this->for_variable.clear();
-                        output = result;
+                        output.clear();
                 }
         }
         return output;
 }
 
-std::vector<std::string> Preprocessor::get_variable_values(std::string variable) {
-        std::vector<std::string> result;
+void Preprocessor::process_csv_loop(const std::string& variable, const std::string& source, const Template& body, std::string& output) {
+        this->context->logger->debug("Processing for loop over rows of: " + source);
+        std::unique_ptr<CsvReader> reader;
+        try {
+                reader = std::make_unique<CsvReader>(std::filesystem::path(source));
+        } catch (const std::exception& e) {
+                this->context->logger->error("Error opening row source for for loop: {}", e.what());
+                end(this->context.get());
+        }
+        auto next = [this, &reader, &source](std::vector<std::string>& fields) {
+                try {
+                        return reader->next(fields);
+                } catch (const std::exception& e) {
+                        this->context->logger->error("Error reading {}: {}", source, e.what());
+                        end(this->context.get());
+                }
+                return false;
+        };
+
+        std::vector<std::string> headers;
+        if (!next(headers)) {
+                this->context->logger->debug("Row source is empty, nothing to iterate over.");
+                return;
+        }
+        std::vector<std::string> keys;
+        keys.reserve(headers.size());
+        for (const std::string& header : headers) {
+                keys.push_back(variable + "." + header);
+        }
+
+        std::vector<std::string> fields;
+        while (next(fields)) {
+                if (fields.size() != headers.size()) {
+                        this->context->logger->error("Row {} of {} has {} columns, expected {}", reader->get_record_count() - 1, source, fields.size(), headers.size());
+                        end(this->context.get());
+                }
+                count_loop_iteration();
+                this->context->logger->trace("Processing row {} of {}", reader->get_record_count() - 1, source);
+                for (std::size_t i = 0; i < keys.size(); ++i) {
+                        bind_variable(keys[i]).assign(1, fields[i]);
+                }
+                bind_variable(variable) = fields;
+                process_all(body, output);
+        }
+}
+
+void Preprocessor::process_element_loop(const std::string& variable, const std::string& source, const Template& body, std::string& output) {
+        this->context->logger->debug("Processing for loop over elements of: " + source);
+        auto for_each_element = std::filesystem::path(source).extension() == ".xml" ? &XmlParser::for_each_element : &JsonParser::for_each_element;
+        std::vector<std::string> bound;
+        std::exception_ptr body_error;
+        try {
+                for_each_element(source, [&](Data& element) {
+                        for (const std::string& name : bound) {
+                                this->context->variables.erase(name);
+                        }
+                        bound.clear();
+                        bind_element(variable, element, bound);
+                        try {
+                                count_loop_iteration();
+                                process_all(body, output);
+                        } catch (...) {
+                                body_error = std::current_exception();
+                                return false;
+                        }
+                        return true;
+                });
+        } catch (const std::exception& e) {
+                this->context->logger->error("Error reading row source for for loop: {}", e.what());
+                end(this->context.get());
+        }
+        if (body_error) {
+                std::rethrow_exception(body_error);
+        }
+}
+
+void Preprocessor::bind_element(const std::string& name, const Data& element, std::vector<std::string>& bound) {
+        if (element.is_map()) {
+                for (const auto& [key, value] : element.as_map()) {
+                        bind_element(name + "." + key, value, bound);
+                }
+                return;
+        }
+        std::vector<std::string> values;
+        if (element.is_array()) {
+                for (std::size_t i = 0; i < element.as_array().size(); ++i) {
+                        const Data& item = element.as_array()[i];
+                        if (item.is_map() || item.is_array()) {
+                                bind_element(name + "." + std::to_string(i), item, bound);
+                        } else {
+                                values.push_back(item.is_null() ? "" : item.as_string());
+                        }
+                }
+        } else {
+                values.push_back(element.is_null() ? "" : element.as_string());
+        }
+        bind_variable(name) = std::move(values);
+        bound.push_back(name);
+}
+
+std::vector<std::string>& Preprocessor::bind_variable(const std::string& name) {
+        auto [variable, inserted] = this->context->variables.try_emplace(name);
+        if (this->bound_variables && !this->bound_variables->contains(name)) {
+                this->bound_variables->emplace(name, inserted ? std::nullopt : std::optional(variable->second));
+        }
+        return variable->second;
+}
+
+std::shared_ptr<const Template> Preprocessor::get_compiled_macro(const std::string& macro_name) {
+        auto it = this->compiled_macros.find(macro_name);
+        if (it != this->compiled_macros.end() &&
+            it->second->matches(this->context->rules.variable_prefix.value(), this->context->rules.variable_suffix.value())) {
+                return it->second;
+        }
+        this->context->logger->trace("Compiling macro: " + macro_name);
+        auto compiled = std::make_shared<const Template>(compile(this->context->macros[macro_name]));
+        this->compiled_macros[macro_name] = compiled;
+        return compiled;
+}
+
+std::pmr::vector<std::pmr::string> Preprocessor::get_variable_values(std::string_view variable) {
+        std::pmr::vector<std::pmr::string> result(&this->pool);
         while (!variable.empty()) {
-                this->context->logger->trace("Processing variable: " + variable);
+                this->context->logger->trace("Processing variable: {}", variable);
                 if (variable.starts_with("\"")) {
                         this->context->logger->trace("Variable is a quoted string");
                         size_t end_quote = variable.find('"', 1);
-                        if (end_quote == std::string::npos) {
-                                this->context->logger->error("Unmatched quote in variable: " + variable);
+                        if (end_quote == std::string_view::npos) {
+                                this->context->logger->error("Unmatched quote in variable: {}", variable);
                                 end(this->context.get());
                         }
-                        result.push_back(variable.substr(1, end_quote - 1));
-                        variable.erase(0, end_quote + 1);
-                        this->context->logger->trace("Extracted quoted string: " + result.back());
+                        result.emplace_back(variable.substr(1, end_quote - 1));
+                        variable.remove_prefix(end_quote + 1);
+                        this->context->logger->trace("Extracted quoted string: {}", result.back());
                 } else if (variable.ends_with("#")) {
                         this->context->logger->trace("Variable ends with '#', getting size of array variable");
-                        result.push_back(std::to_string(context->variables[variable.substr(0, variable.length() - 1)].size()));
-                        variable.erase(0, variable.length());
-                        this->context->logger->trace("Extracted size of array variable: " + result.back());
+                        auto array = context->variables.find(std::string(variable.substr(0, variable.length() - 1)));
+                        result.emplace_back(std::to_string(array == context->variables.end() ? 0 : array->second.size()));
+                        variable = {};
+                        this->context->logger->trace("Extracted size of array variable: {}", result.back());
                 } else {
                         this->context->logger->trace("Variable is a normal variable or array access");
                         size_t next_space = variable.find_first_of(" ");
                         std::string variable_name;
-                        std::string variable_value;
-                        if (next_space == std::string::npos) {
+                        if (next_space == std::string_view::npos) {
                                 this->context->logger->trace("No space found in variable, using entire variable as name");
                                 variable_name = variable;
-                                variable.erase(0, variable.length());
+                                variable = {};
                         } else {
                                 this->context->logger->trace("Space found in variable, splitting at first space");
                                 variable_name = variable.substr(0, next_space);
-                                variable.erase(0, next_space);
+                                variable.remove_prefix(next_space);
                         }
 
                         int index = 0;
@@ -600,22 +1043,22 @@ std::vector<std::string> Preprocessor::get_variable_values(std::string variable)
                         }
 
                         this->context->logger->trace("Checking if variable exists");
-                        if (context->variables.find(variable_name) != context->variables.end()) {
-                                if (index < 0 || index >= context->variables[variable_name].size()) {
+                        auto found = context->variables.find(variable_name);
+                        if (found != context->variables.end()) {
+                                if (index < 0 || index >= found->second.size()) {
                                         this->context->logger->error("Index out of bounds for variable: " + variable_name);
                                         end(this->context.get());
                                 }
-                                variable_value = context->variables[variable_name][index];
-                                this->context->logger->trace("Found variable: " + variable_name + " with value: " + variable_value);
+                                result.emplace_back(found->second[index]);
+                                this->context->logger->trace("Found variable: {} with value: {}", variable_name, result.back());
                         } else {
-                                variable_value = variable_name;
+                                result.emplace_back(variable_name);
                         }
-
-                        this->context->logger->trace("Adding variable value to result: " + variable_value);
-                        result.push_back(variable_value);
+                        this->context->logger->trace("Adding variable value to result: {}", result.back());
                 }
-                this->context->logger->trace("Trimming variable string: " + variable);
-                variable.erase(0, variable.find_first_not_of(" \t\n\r\f\v"));
+                this->context->logger->trace("Trimming variable string: {}", variable);
+                std::size_t first = variable.find_first_not_of(" \t\n\r\f\v");
+                variable.remove_prefix(first == std::string_view::npos ? variable.size() : first);
         }
         return result;
 }
@@ -640,8 +1083,8 @@ std::map<std::string,std::vector<std::string>> Preprocessor::get_variables(const
                         this->context->logger->trace("Variable is a string: " + value.as_string());
                         variable_list[variable_name] = {value.as_string()};
                 } else if (value.is_int()) {
-                        this->context->logger->trace("Variable is an integer: " + std::to_string(value.as_int()));
-                        variable_list[variable_name] = {std::to_string(value.as_int())};
+                        this->context->logger->trace("Variable is an integer: " + std::to_string(value.as_int64()));
+                        variable_list[variable_name] = {std::to_string(value.as_int64())};
                 } else if (value.is_double()) {
                         this->context->logger->trace("Variable is a double: " + std::to_string(value.as_double()));
                         variable_list[variable_name] = {std::to_string(value.as_double())};
@@ -660,8 +1103,8 @@ std::map<std::string,std::vector<std::string>> Preprocessor::get_variables(const
                                         this->context->logger->trace("Array item is a string: " + item.as_string());
                                         variable_list[variable_name] = {item.as_string()};
                                 } else if (item.is_int()) {
-                                        this->context->logger->trace("Array item is an integer: " + std::to_string(item.as_int()));
-                                        variable_list[variable_name] = {std::to_string(item.as_int())};
+                                        this->context->logger->trace("Array item is an integer: " + std::to_string(item.as_int64()));
+                                        variable_list[variable_name] = {std::to_string(item.as_int64())};
                                 } else if (item.is_double()) {
                                         this->context->logger->trace("Array item is a double: " + std::to_string(item.as_double()));
                                         variable_list[variable_name] = {std::to_string(item.as_double())};
@@ -736,10 +1179,33 @@ void Preprocessor::make_benchmark() const {
                 auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - context->start_time);
                 std::cout << "Time: " << this->get_time_conversion(duration) << std::endl;
         }
+        if (context->rules.benchmark.value() == Benchmark::MEMORY || context->rules.benchmark.value() == Benchmark::ALL) {
+                // Copy first: printing allocates, and the render is still being counted.
+                MemoryStats memory = context->memory_stats;
+                const char* scope = memory.complete ? "" : " (partial)";
+                std::cout << "Memory peak" << scope << ": " << this->get_memory_conversion(memory.peak_bytes) << std::endl;
+                std::cout << "Memory allocated" << scope << ": " << this->get_memory_conversion(memory.allocated_bytes)
+                          << " in " << memory.allocations << " allocations" << std::endl;
+                std::cout << "Memory retained by caches: " << this->get_memory_conversion(memory.retained_bytes) << std::endl;
+        }
+        if (this->macro_cache.get_hits() + this->macro_cache.get_misses() > 0) {
+                std::cout << "Pure macro calls: " << this->macro_cache.get_hits() << " cache hits, "
+                          << this->macro_cache.get_misses() << " misses" << std::endl;
+        }
         std::cout << "Includes processed: " << context->include_counter << std::endl;
         std::cout << "Current Variables set: " << context->variables.size() << " variables." << std::endl;
 }
 
+std::string Preprocessor::get_memory_conversion(std::size_t bytes) const {
+    if (bytes >= 1024 * 1024) {
+            return std::to_string(bytes / (1024 * 1024)) + "." + std::to_string(bytes % (1024 * 1024) * 10 / (1024 * 1024)) + "MiB";
+    } else if (bytes >= 1024) {
+            return std::to_string(bytes / 1024) + "." + std::to_string(bytes % 1024 * 10 / 1024) + "KiB";
+    } else {
+            return std::to_string(bytes) + "B";
+    }
+}
+
 std::string Preprocessor::get_time_conversion(const std::chrono::nanoseconds& duration) const {
     auto seconds = std::chrono::duration_cast<std::chrono::seconds>(duration);
     auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(duration - seconds);
@@ -1,37 +1,92 @@
 #include "processor/ProcessingVariables.h"
 
+#include <algorithm>
+
 namespace prebyte {
 
-ProcessingVariables::ProcessingVariables(Context* context) : context(context), current_time(std::chrono::system_clock::now()) {
-        functionality = {
-        { "__DATE__",          [this]() { return this->_DATE(); } },
-        { "__TIME__",          [this]() { return this->_TIME(); } },
-        { "__DATETIME__",      [this]() { return this->_DATETIME(); } },
-        { "__YEAR__",          [this]() { return this->_YEAR(); } },
-        { "__MONTH__",         [this]() { return this->_MONTH(); } },
-        { "__DAY__",           [this]() { return this->_DAY(); } },
-        { "__HOUR__",          [this]() { return this->_HOUR(); } },
-        { "__MINUTE__",        [this]() { return this->_MINUTE(); } },
-        { "__SECOND__",        [this]() { return this->_SECOND(); } },
-        { "__UNIXTIMESTAMP__", [this]() { return this->_UNIXTIMESTAMP(); } },
-        { "__USER__",          [this]() { return this->_USER(); } },
-        { "__HOST__",          [this]() { return this->_HOST(); } },
-        { "__PWD__",           [this]() { return this->_PWD(); } },
-        { "__VERSION__",       [this]() { return this->_VERSION(); } },
-        { "__FILE__",          [this]() { return this->_FILE(); } },
-        { "__FILE_NAME__",     [this]() { return this->_FILE_NAME(); } },
-        { "__FILE_PATH__",     [this]() { return this->_FILE_PATH(); } },
-        { "__FILE_EXT__",      [this]() { return this->_FILE_EXT(); } },
-        { "__FILE_SIZE__",     [this]() { return this->_FILE_SIZE(); } },
-        { "__FILE_CREATED__",  [this]() { return this->_FILE_CREATED(); } },
-        { "__LINE__",          [this]() { return this->_LINE(); } }
-    };
-}
-
-
-std::tm ProcessingVariables::getLocalTime() const {
-    std::time_t t = std::chrono::system_clock::to_time_t(this->current_time);
-    return *std::localtime(&t);
+namespace {
+
+/// Variable keys sorted by name, so lookups can use a binary search without allocating.
+constexpr std::array<std::pair<std::string_view, VariableAction>, VARIABLE_ACTION_COUNT> VARIABLE_KEYS = {{
+        { "__DATETIME__",      VariableAction::DATETIME },
+        { "__DATE__",          VariableAction::DATE },
+        { "__DAY__",           VariableAction::DAY },
+        { "__FILE_CREATED__",  VariableAction::FILE_CREATED },
+        { "__FILE_EXT__",      VariableAction::FILE_EXT },
+        { "__FILE_NAME__",     VariableAction::FILE_NAME },
+        { "__FILE_PATH__",     VariableAction::FILE_PATH },
+        { "__FILE_SIZE__",     VariableAction::FILE_SIZE },
+        { "__FILE__",          VariableAction::FILE },
+        { "__HOST__",          VariableAction::HOST },
+        { "__HOUR__",          VariableAction::HOUR },
+        { "__LINE__",          VariableAction::LINE },
+        { "__MINUTE__",        VariableAction::MINUTE },
+        { "__MONTH__",         VariableAction::MONTH },
+        { "__PWD__",           VariableAction::PWD },
+        { "__SECOND__",        VariableAction::SECOND },
+        { "__TIME__",          VariableAction::TIME },
+        { "__UNIXTIMESTAMP__", VariableAction::UNIXTIMESTAMP },
+        { "__USER__",          VariableAction::USER },
+        { "__VERSION__",       VariableAction::VERSION },
+        { "__YEAR__",          VariableAction::YEAR }
+}};
+
+static_assert(std::is_sorted(VARIABLE_KEYS.begin(), VARIABLE_KEYS.end(),
+                             [](const auto& a, const auto& b) { return a.first < b.first; }),
+              "VARIABLE_KEYS must be sorted by key");
+
+}
+
+ProcessingVariables::ProcessingVariables(Context* context) : current_time(std::chrono::system_clock::now()), context(context) {
+}
+
+
+std::optional<VariableAction> ProcessingVariables::find_action(std::string_view key) {
+        auto it = std::lower_bound(VARIABLE_KEYS.begin(), VARIABLE_KEYS.end(), key,
+                                   [](const auto& entry, std::string_view value) { return entry.first < value; });
+        if (it != VARIABLE_KEYS.end() && it->first == key) {
+                return it->second;
+        }
+        return std::nullopt;
+}
+
+
+std::string ProcessingVariables::compute(VariableAction action) const {
+        switch (action) {
+                case VariableAction::DATE:          return _DATE();
+                case VariableAction::TIME:          return _TIME();
+                case VariableAction::DATETIME:      return _DATETIME();
+                case VariableAction::LINE:          return _LINE();
+                case VariableAction::VERSION:       return _VERSION();
+                case VariableAction::YEAR:          return _YEAR();
+                case VariableAction::MONTH:         return _MONTH();
+                case VariableAction::DAY:           return _DAY();
+                case VariableAction::HOUR:          return _HOUR();
+                case VariableAction::MINUTE:        return _MINUTE();
+                case VariableAction::SECOND:        return _SECOND();
+                case VariableAction::UNIXTIMESTAMP: return _UNIXTIMESTAMP();
+                case VariableAction::USER:          return _USER();
+                case VariableAction::HOST:          return _HOST();
+                case VariableAction::PWD:           return _PWD();
+                case VariableAction::FILE:          return _FILE();
+                case VariableAction::FILE_NAME:     return _FILE_NAME();
+                case VariableAction::FILE_PATH:     return _FILE_PATH();
+                case VariableAction::FILE_EXT:      return _FILE_EXT();
+                case VariableAction::FILE_SIZE:     return _FILE_SIZE();
+                case VariableAction::FILE_CREATED:  return _FILE_CREATED();
+        }
+        return "";
+}
+
+
+const std::tm& ProcessingVariables::getLocalTime() const {
+    if (!this->local_time) {
+        std::time_t t = std::chrono::system_clock::to_time_t(this->current_time);
+        std::tm local{};
+        localtime_r(&t, &local);
+        this->local_time = local;
+    }
+    return *this->local_time;
 }
 
 
@@ -42,21 +97,19 @@ std::string ProcessingVariables::_DATE() const {
 }
 
 std::string ProcessingVariables::_TIME() const {
-        std::time_t t = std::chrono::system_clock::to_time_t(this->current_time);
-        std::tm* now = std::localtime(&t);
-        return std::format("{:02}:{:02}:{:02}", now->tm_hour, now->tm_min, now->tm_sec);
+        const std::tm& now = getLocalTime();
+        return std::format("{:02}:{:02}:{:02}", now.tm_hour, now.tm_min, now.tm_sec);
 }
 
 std::string ProcessingVariables::_DATETIME() const {
-        std::time_t t = std::chrono::system_clock::to_time_t(this->current_time);
-        std::tm* local = std::localtime(&t);
+        const std::tm& local = getLocalTime();
         return std::format("{:04}-{:02}-{:02} {:02}:{:02}:{:02}",
-                local->tm_year + 1900,
-                local->tm_mon + 1,
-                local->tm_mday,
-                local->tm_hour,
-                local->tm_min,
-                local->tm_sec);
+                local.tm_year + 1900,
+                local.tm_mon + 1,
+                local.tm_mday,
+                local.tm_hour,
+                local.tm_min,
+                local.tm_sec);
 }
 
 
@@ -191,7 +244,8 @@ std::string ProcessingVariables::_FILE_CREATED() const {
                 auto ftime = std::filesystem::last_write_time(input_path);
                 auto sctp = std::chrono::time_point_cast<std::chrono::system_clock::duration>(ftime - std::filesystem::file_time_type::clock::now() + std::chrono::system_clock::now());
                 std::time_t ctime = std::chrono::system_clock::to_time_t(sctp);
-                return std::ctime(&ctime);
+                char buffer[26];
+                return ctime_r(&ctime, buffer);
             }
         }
         return "";
@@ -205,11 +259,15 @@ bool ProcessingVariables::is_valid(const std::string& key) const {
 
 
 std::string ProcessingVariables::get_value(const std::string& key) const {
-        auto it = functionality.find(key);
-        if (it != functionality.end()) {
-                return it->second();
+        std::optional<VariableAction> action = find_action(key);
+        if (!action) {
+                return "";
         }
-        return "";
+        std::optional<std::string>& cached = this->cache[static_cast<std::size_t>(*action)];
+        if (!cached) {
+                cached = compute(*action);
+        }
+        return *cached;
 }
 
 
@@ -1,11 +1,79 @@
 #include "processor/Processor.h"
 
+#include <cctype>
+
 namespace prebyte {
 
+std::unique_ptr<Context> Processor::release_context() {
+        return std::move(this->context);
+}
+
+std::string Processor::get_input() const {
+    std::string input_data;
+    this->context->logger->debug("Getting input for action type: " + std::to_string(static_cast<int>(context->action_type)));
+
+    switch (context->action_type) {
+        case ActionType::FILE_IN_FILE_OUT:
+        case ActionType::FILE_IN_API_OUT:
+        case ActionType::FILE_IN_SINK_OUT:
+        case ActionType::FILE_IN_STDOUT: {
+            std::filesystem::path input_path = context->inputs[0];
+            std::ifstream input_file(input_path);
+            if (!input_file) {
+                this->context->logger->error("Error opening input file: " + input_path.string());
+                end(this->context.get());
+            }
+
+            this->context->logger->debug("Reading input from file: " + input_path.string());
+
+            input_data.assign(
+                std::istreambuf_iterator<char>(input_file),
+                std::istreambuf_iterator<char>()
+            );
+
+            if (input_data.empty()) {
+                this->context->logger->warn("Input file is empty.");
+                return "";
+            }
+
+            this->context->logger->debug("Input file read successfully.");
+            break;
+        }
+
+        case ActionType::STDIN_FILE_OUT:
+        case ActionType::STDIN_STDOUT: {
+            std::ostringstream ss;
+            ss << std::cin.rdbuf();
+            input_data = ss.str();
+
+            if (input_data.empty()) {
+                this->context->logger->warn("No input provided on stdin.");
+                return "";
+            }
+            break;
+        }
+
+        case ActionType::API_IN_FILE_OUT:
+        case ActionType::API_IN_SINK_OUT:
+        case ActionType::API_IN_API_OUT: {
+                if (context->input.empty()) {
+                        this->context->logger->warn("No input provided for API action.");
+                        return "";
+                }
+                this->context->logger->debug("Using provided input for API action.");
+                return context->input;
+        }
+        default:
+            this->context->logger->error("Unknown action type for input: " + std::to_string(static_cast<int>(context->action_type)));
+            end(this->context.get());
+    }
+
+    return input_data;
+}
 
 std::string Processor::get_variable_value(const std::string& action, bool pattern) const {
     static const std::regex var_pattern(
-        R"(^([a-zA-Z][a-zA-Z0-9_]*)(?:\[(\d+)\])?$)"
+        R"(^([a-zA-Z][a-zA-Z0-9_.@]*)(?:\[(\d+)\])?$)"
     );
 
     std::smatch match;
@@ -18,7 +86,24 @@ std::string Processor::get_variable_value(const std::string& action, bool patter
 }
 
 std::string Processor::get_variable_name(const std::string& action) const {
-        return get_variable_value(action, false);
+        return std::string(get_variable_name_view(action));
+}
+
+std::string_view Processor::get_variable_name_view(std::string_view action) const {
+        // Same grammar as get_variable_value: name, optionally followed by [index].
+        auto is_name_char = [](char c) {
+                return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.' || c == '@';
+        };
+        if (action.empty() || !std::isalpha(static_cast<unsigned char>(action.front()))) return {};
+        std::size_t name_end = 1;
+        while (name_end < action.size() && is_name_char(action[name_end])) ++name_end;
+        if (name_end == action.size()) return action;
+
+        if (action[name_end] != '[' || action.back() != ']' || name_end + 2 >= action.size()) return {};
+        for (std::size_t i = name_end + 1; i + 1 < action.size(); ++i) {
+                if (!std::isdigit(static_cast<unsigned char>(action[i]))) return {};
+        }
+        return action.substr(0, name_end);
 }
 
 int Processor::get_variable_number(const std::string& action) const {
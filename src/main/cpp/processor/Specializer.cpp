@@ -0,0 +1,412 @@
+#include "processor/Specializer.h"
+
+#include "datatypes/OutputFile.h"
+
+namespace prebyte {
+
+namespace {
+
+/// Checks whether an action mentions a name as a whole word, e.g. `name`, `name[0]` or `name == "x"`.
+bool mentions(std::string_view action, const std::string& name) {
+        auto is_word = [](char c) {
+                return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.' || c == '@';
+        };
+        std::size_t position = 0;
+        while (position < action.size()) {
+                while (position < action.size() && !is_word(action[position])) ++position;
+                std::size_t start = position;
+                while (position < action.size() && is_word(action[position])) ++position;
+                if (action.substr(start, position - start) == name) return true;
+        }
+        return false;
+}
+
+}
+
+Specializer::Specializer(std::unique_ptr<Context> context) : Processor(),
+        safe_macros({}, [this](const std::string& macro_name) -> std::shared_ptr<const Template> {
+                // The first definition wins, so macros of the context come before the input's.
+                const std::string* body = nullptr;
+                if (auto defined = this->context->macros.find(macro_name); defined != this->context->macros.end()) {
+                        body = &defined->second;
+                } else if (auto defined = this->defined_macros.find(macro_name); defined != this->defined_macros.end()) {
+                        body = &defined->second;
+                } else {
+                        return nullptr;
+                }
+                return std::make_shared<const Template>(Template::compile(*body, this->context->rules.variable_prefix.value(), this->context->rules.variable_suffix.value()));
+        }),
+        conditions([this](const std::string& name) { return resolve_operand(name); }) {
+        this->context = std::move(context);
+}
+
+void Specializer::process() {
+        this->context->logger->info("Specializing input...");
+        std::string input = get_input();
+        std::string residual = specialize(input, this->context->constants);
+
+        if (this->context->action_type == ActionType::FILE_IN_FILE_OUT || this->context->action_type == ActionType::STDIN_FILE_OUT) {
+                std::filesystem::path output_path = this->context->action_type == ActionType::FILE_IN_FILE_OUT ? this->context->inputs[1] : this->context->inputs[0];
+                this->context->logger->debug("Writing residual template to file: " + output_path.string());
+                try {
+                        if (!OutputFile::write(output_path, residual, this->context->rules.skip_unchanged_output.value_or(false))) {
+                                this->context->logger->debug("Output file is unchanged, keeping: " + output_path.string());
+                        }
+                } catch (const std::exception& e) {
+                        this->context->logger->error(e.what());
+                        end(this->context.get());
+                }
+                return;
+        }
+        std::cout << residual;
+}
+
+std::string Specializer::specialize(const std::string& input, const std::vector<std::string>& constants) {
+        this->constants.clear();
+        this->safe_macros.clear();
+        this->defined_macros.clear();
+        this->residual_actions.clear();
+        this->frozen = false;
+        this->folded_actions = 0;
+        this->pruned_branches = 0;
+        this->unrolled_loops = 0;
+
+        if (constants.empty()) {
+                for (const auto& [name, values] : this->context->variables) {
+                        this->constants.insert(name);
+                }
+        } else {
+                for (const std::string& name : constants) {
+                        if (!this->context->variables.contains(name)) {
+                                this->context->logger->warn("Constant '{}' is not defined and stays dynamic", name);
+                                continue;
+                        }
+                        this->constants.insert(name);
+                }
+        }
+        this->context->logger->debug("Specializing against {} constant variables", this->constants.size());
+
+        Template compiled = Template::compile(input, this->context->rules.variable_prefix.value(), this->context->rules.variable_suffix.value());
+        this->current = &compiled;
+        std::string residual;
+        specialize_range(0, compiled.get_segments().size(), residual);
+        this->current = nullptr;
+
+        // A folded value can form a prefix together with the text around it. The
+        // residual must split into exactly the actions that were written.
+        Template check = Template::compile(residual, this->context->rules.variable_prefix.value(), this->context->rules.variable_suffix.value());
+        std::size_t action = 0;
+        bool same = true;
+        for (const Segment& segment : check.get_segments()) {
+                if (segment.type != SegmentType::ACTION && !segment.unterminated) continue;
+                if (segment.unterminated || action == this->residual_actions.size() || segment.content != this->residual_actions[action]) {
+                        same = false;
+                        break;
+                }
+                action++;
+        }
+        if (!same || action != this->residual_actions.size()) {
+                this->context->logger->warn("Folded values would change how the input is read, keeping the input unchanged");
+                return input;
+        }
+
+        this->context->logger->info("Specialized input: {} variables folded, {} conditions resolved, {} loops unrolled",
+                                    this->folded_actions, this->pruned_branches, this->unrolled_loops);
+        return residual;
+}
+
+void Specializer::specialize_range(std::size_t first, std::size_t last, std::string& out) {
+        const std::vector<Segment>& segments = this->current->get_segments();
+        std::vector<Chain> chains;
+        auto emitting = [&chains]() { return chains.empty() || chains.back().emitting; };
+
+        for (std::size_t i = first; i < last; ++i) {
+                const Segment& segment = segments[i];
+                if (segment.unterminated) {
+                        this->context->logger->error("Variable suffix not found in input.");
+                        end(this->context.get());
+                }
+                if (segment.type == SegmentType::TEXT) {
+                        if (emitting()) out += segment.content;
+                        continue;
+                }
+
+                FlowType type = segment.directive.type;
+                std::string arguments(segment.directive.arguments(segment.content));
+                if (type == FlowType::IF) {
+                        Chain chain;
+                        chain.live = emitting();
+                        if (chain.live) {
+                                ConditionEvaluator::Result condition = this->frozen ? ConditionEvaluator::Result{std::nullopt, arguments} : this->conditions.evaluate(arguments);
+                                if (condition.value) {
+                                        this->pruned_branches++;
+                                        chain.decided = *condition.value;
+                                        chain.emitting = *condition.value;
+                                } else {
+                                        emit_action(out, "if " + condition.residual);
+                                        chain.open = true;
+                                        chain.emitting = true;
+                                }
+                        }
+                        chains.push_back(chain);
+                        continue;
+                }
+                if (type == FlowType::ELSE_IF || type == FlowType::ELSE || type == FlowType::ENDIF) {
+                        if (chains.empty()) {
+                                // Closes a block opened before this range; nothing to follow.
+                                emit_source(out, i, i + 1);
+                                this->frozen = true;
+                                continue;
+                        }
+                        Chain& chain = chains.back();
+                        if (type == FlowType::ENDIF) {
+                                if (chain.open) emit_action(out, "endif");
+                                chains.pop_back();
+                                continue;
+                        }
+                        if (!chain.live) continue;
+                        if (chain.decided) {
+                                chain.emitting = false;
+                                continue;
+                        }
+                        if (type == FlowType::ELSE) {
+                                if (chain.open) emit_action(out, "else");
+                                chain.decided = true;
+                                chain.emitting = true;
+                                continue;
+                        }
+                        ConditionEvaluator::Result condition = this->frozen ? ConditionEvaluator::Result{std::nullopt, arguments} : this->conditions.evaluate(arguments);
+                        if (condition.value) {
+                                this->pruned_branches++;
+                                chain.emitting = *condition.value;
+                                if (*condition.value) {
+                                        if (chain.open) emit_action(out, "else");
+                                        chain.decided = true;
+                                }
+                                continue;
+                        }
+                        emit_action(out, (chain.open ? "elif " : "if ") + condition.residual);
+                        chain.open = true;
+                        chain.emitting = true;
+                        continue;
+                }
+                if (!emitting()) continue;
+
+                switch (type) {
+                        case FlowType::NONE: {
+                                std::optional<std::string> value = this->frozen ? std::nullopt : fold_action(segment.content);
+                                if (value) {
+                                        this->folded_actions++;
+                                        out += *value;
+                                } else {
+                                        emit_source(out, i, i + 1);
+                                }
+                                break;
+                        }
+                        case FlowType::FOR: {
+                                std::size_t loop_end = find_block_end(i, last, FlowType::FOR, FlowType::ENDFOR);
+                                if (loop_end == last) {
+                                        emit_source(out, i, last);
+                                        this->frozen = true;
+                                        return;
+                                }
+                                specialize_loop(i, loop_end, out);
+                                i = loop_end;
+                                break;
+                        }
+                        case FlowType::DEFINE_MACRO:
+                        case FlowType::DEFINE_PROFILE: {
+                                std::size_t define_end = find_block_end(i, last, FlowType::END_DEFINE, FlowType::END_DEFINE);
+                                emit_source(out, i, std::min(define_end + 1, last));
+                                if (define_end == last) {
+                                        this->frozen = true;
+                                        return;
+                                }
+                                if (type == FlowType::DEFINE_MACRO) {
+                                        std::string macro_name = arguments.substr(0, arguments.find(' '));
+                                        this->defined_macros.try_emplace(macro_name, this->current->source_of(i + 1, define_end));
+                                }
+                                // The body runs when it is defined, so its directives change state then.
+                                if (!this->frozen && !this->safe_macros.is_pure(segments, i + 1, define_end)) {
+                                        this->frozen = true;
+                                }
+                                i = define_end;
+                                break;
+                        }
+                        case FlowType::EXECUTE_MACRO:
+                                emit_source(out, i, i + 1);
+                                if (!this->frozen && !this->safe_macros.is_pure(arguments.substr(0, arguments.find(' ')))) {
+                                        this->context->logger->debug("Macro call may change state, keeping the rest of the input: " + segment.content);
+                                        this->frozen = true;
+                                }
+                                break;
+                        case FlowType::SET_VAR:
+                        case FlowType::UNSET_VAR:
+                                emit_source(out, i, i + 1);
+                                this->constants.erase(type == FlowType::SET_VAR ? arguments.substr(0, arguments.find('=')) : arguments);
+                                break;
+                        default:
+                                this->context->logger->debug("Directive changes state, keeping the rest of the input: " + segment.content);
+                                emit_source(out, i, i + 1);
+                                this->frozen = true;
+                                break;
+                }
+        }
+}
+
+void Specializer::specialize_loop(std::size_t index, std::size_t end, std::string& out) {
+        const std::vector<Segment>& segments = this->current->get_segments();
+        const Segment& segment = segments[index];
+        std::string arguments(segment.directive.arguments(segment.content));
+        std::string variable = arguments.substr(0, arguments.find(' '));
+        std::string array = arguments.substr(arguments.find_last_of(' ') + 1);
+
+        // Only bodies without side effects can be specialized; everything else
+        // in a body runs while the loop is read, not per iteration.
+        bool eligible = !this->frozen;
+        bool builtins = false;
+        int depth = 0;
+        for (std::size_t i = index + 1; i < end && eligible; ++i) {
+                if (segments[i].type != SegmentType::ACTION) continue;
+                const Directive& directive = segments[i].directive;
+                if (directive.type == FlowType::IF) depth++;
+                else if (directive.type == FlowType::ENDIF) depth--;
+                else if (directive.type == FlowType::NONE) builtins |= segments[i].content.starts_with("__");
+                else if (!directive.is_conditional() && directive.type != FlowType::FOR && directive.type != FlowType::ENDFOR) eligible = false;
+                if (depth < 0) eligible = false;
+        }
+        if (!eligible || depth != 0) {
+                emit_source(out, index, end + 1);
+                this->frozen = true;
+                return;
+        }
+
+        if (array.ends_with("\"")) {
+                // Rows of a file are bound to the variable and its `<variable>.<column>` members.
+                emit_source(out, index, end + 1);
+                std::erase_if(this->constants, [&variable](const std::string& name) {
+                        return name == variable || name.starts_with(variable + ".");
+                });
+                return;
+        }
+
+        auto found = this->context->variables.find(array);
+        if (this->constants.contains(array) && found != this->context->variables.end() && !builtins && !referenced_after(end, variable)) {
+                const std::vector<std::string> values = found->second;
+                std::optional<std::vector<std::string>> saved;
+                if (auto bound = this->context->variables.find(variable); bound != this->context->variables.end()) {
+                        saved = bound->second;
+                }
+                bool was_constant = this->constants.contains(variable);
+                std::size_t actions = this->residual_actions.size();
+                std::size_t folded = this->folded_actions;
+                std::size_t pruned = this->pruned_branches;
+
+                std::string unrolled;
+                bool complete = true;
+                this->constants.insert(variable);
+                for (const std::string& value : values) {
+                        this->context->variables[variable] = {value};
+                        std::size_t iteration_start = this->residual_actions.size();
+                        specialize_range(index + 1, end, unrolled);
+                        // The loop variable does not exist in the residual, so no action may still read it.
+                        for (std::size_t i = iteration_start; i < this->residual_actions.size() && complete; ++i) {
+                                complete = !mentions(this->residual_actions[i], variable);
+                        }
+                        if (!complete) break;
+                }
+
+                if (saved) this->context->variables[variable] = std::move(*saved);
+                else this->context->variables.erase(variable);
+                if (!was_constant) this->constants.erase(variable);
+
+                if (complete) {
+                        this->context->logger->debug("Unrolled loop over {} with {} iterations", array, values.size());
+                        this->unrolled_loops++;
+                        out += unrolled;
+                        return;
+                }
+                this->residual_actions.resize(actions);
+                this->folded_actions = folded;
+                this->pruned_branches = pruned;
+        }
+
+        // The loop stays. Its variable changes per iteration and keeps the last value afterwards.
+        this->constants.erase(variable);
+        emit_source(out, index, index + 1);
+        specialize_range(index + 1, end, out);
+        emit_source(out, end, end + 1);
+}
+
+std::optional<std::string> Specializer::fold_action(const std::string& action) const {
+        if (action.find(' ') != std::string::npos) return std::nullopt;
+        if (this->context->ignore.matches(action)) return std::nullopt;
+        if (action.starts_with("__") && action.ends_with("__")) return std::nullopt;
+
+        std::string variable_name = get_variable_name(action);
+        if (variable_name.empty() || variable_name.starts_with("ARGS") || !this->constants.contains(variable_name)) return std::nullopt;
+        auto found = this->context->variables.find(variable_name);
+        if (found == this->context->variables.end()) return std::nullopt;
+
+        // `@path` values are read from the file on every render.
+        int index = get_variable_number(action);
+        if (index >= 0 && static_cast<std::size_t>(index) < found->second.size()) {
+                const std::string& raw = found->second[index];
+                if (raw.starts_with("@") && !raw.starts_with("@@")) return std::nullopt;
+        }
+
+        std::string value = get_variable(action);
+        if (value.find(this->context->rules.variable_prefix.value()) != std::string::npos) return std::nullopt;
+        return value;
+}
+
+ConditionEvaluator::Operand Specializer::resolve_operand(const std::string& name) const {
+        auto found = this->context->variables.find(name);
+        if (!this->constants.contains(name) || found == this->context->variables.end() || found->second.empty()) {
+                return {std::nullopt, "", name};
+        }
+        const std::string& value = found->second[0];
+        // Characters that would change how the condition is split stay behind the variable name.
+        if (value.find_first_of("\"|&()\r\n") != std::string::npos) return {true, value, name};
+        return {true, value, "\"" + value + "\""};
+}
+
+bool Specializer::referenced_after(std::size_t index, const std::string& name) const {
+        const std::vector<Segment>& segments = this->current->get_segments();
+        for (std::size_t i = index + 1; i < segments.size(); ++i) {
+                if (segments[i].type == SegmentType::ACTION && mentions(segments[i].content, name)) return true;
+        }
+        return false;
+}
+
+void Specializer::emit_action(std::string& out, const std::string& action) {
+        out += this->context->rules.variable_prefix.value() + action + this->context->rules.variable_suffix.value();
+        this->residual_actions.push_back(action);
+}
+
+void Specializer::emit_source(std::string& out, std::size_t first, std::size_t last) {
+        out += this->current->source_of(first, last);
+        const std::vector<Segment>& segments = this->current->get_segments();
+        for (std::size_t i = first; i < last; ++i) {
+                if (segments[i].type == SegmentType::ACTION) {
+                        this->residual_actions.push_back(segments[i].content);
+                }
+        }
+}
+
+std::size_t Specializer::find_block_end(std::size_t index, std::size_t last, FlowType open, FlowType close) const {
+        const std::vector<Segment>& segments = this->current->get_segments();
+        int depth = 0;
+        for (std::size_t i = index + 1; i < last; ++i) {
+                if (segments[i].type != SegmentType::ACTION) continue;
+                if (segments[i].directive.type == close) {
+                        if (depth == 0) return i;
+                        depth--;
+                } else if (segments[i].directive.type == open) {
+                        depth++;
+                }
+        }
+        return last;
+}
+
+}
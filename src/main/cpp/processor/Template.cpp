@@ -0,0 +1,103 @@
+#include "processor/Template.h"
+
+#include <iterator>
+
+namespace prebyte {
+
+Template Template::compile(const std::string& input, const std::string& prefix, const std::string& suffix) {
+        Template compiled;
+        compiled.prefix = prefix;
+        compiled.suffix = suffix;
+
+        if (prefix.empty()) {
+                if (!input.empty()) compiled.segments.push_back({SegmentType::TEXT, input});
+                return compiled;
+        }
+
+        std::size_t position = 0;
+        while (position < input.size()) {
+                std::size_t start = input.find(prefix, position);
+                if (start == std::string::npos) {
+                        compiled.segments.push_back({SegmentType::TEXT, input.substr(position)});
+                        break;
+                }
+                if (start > position) {
+                        compiled.segments.push_back({SegmentType::TEXT, input.substr(position, start - position)});
+                }
+                position = start + prefix.size();
+
+                if (position < input.size() && input[position] == '#') {
+                        std::size_t line_end = input.find('\n', position);
+                        if (line_end == std::string::npos) {
+                                line_end = input.size();
+                        }
+                        std::string content = input.substr(position + 1, line_end - position - 1);
+                        Directive directive = Directive::parse(content);
+                        compiled.segments.push_back({SegmentType::ACTION, std::move(content), true, directive, false});
+                        position = line_end + 1;
+                } else {
+                        std::size_t end = input.find(suffix, position);
+                        if (suffix.empty() || end == std::string::npos) {
+                                compiled.segments.push_back({SegmentType::TEXT, input.substr(start), false, Directive(), true});
+                                break;
+                        }
+                        std::string content = input.substr(position, end - position);
+                        Directive directive = Directive::parse(content);
+                        compiled.segments.push_back({SegmentType::ACTION, std::move(content), false, directive, false});
+                        position = end + suffix.size();
+                }
+        }
+        return compiled;
+}
+
+const std::vector<Segment>& Template::get_segments() const {
+        return this->segments;
+}
+
+bool Template::matches(const std::string& prefix, const std::string& suffix) const {
+        return this->prefix == prefix && this->suffix == suffix;
+}
+
+std::string Template::source_from(std::size_t index) const {
+        return source_of(index, this->segments.size());
+}
+
+std::string Template::source_of(std::size_t first, std::size_t last) const {
+        std::string source;
+        for (std::size_t i = first; i < last; ++i) {
+                const Segment& segment = this->segments[i];
+                if (segment.type == SegmentType::TEXT) {
+                        source += segment.content;
+                } else if (segment.linewise) {
+                        source += this->prefix + "#" + segment.content + "\n";
+                } else {
+                        source += this->prefix + segment.content + this->suffix;
+                }
+        }
+        return source;
+}
+
+std::vector<Template> Template::split(const std::vector<std::size_t>& starts) && {
+        std::vector<Template> parts(starts.size() + 1);
+        std::size_t first = 0;
+        for (std::size_t part = 0; part < parts.size(); ++part) {
+                std::size_t last = part < starts.size() ? starts[part] : this->segments.size();
+                parts[part].prefix = this->prefix;
+                parts[part].suffix = this->suffix;
+                parts[part].segments.assign(std::make_move_iterator(this->segments.begin() + first),
+                                            std::make_move_iterator(this->segments.begin() + last));
+                first = last;
+        }
+        this->segments.clear();
+        return parts;
+}
+
+std::size_t Template::memory_usage() const {
+        std::size_t bytes = sizeof(Template) + this->segments.capacity() * sizeof(Segment);
+        for (const Segment& segment : this->segments) {
+                bytes += segment.content.capacity();
+        }
+        return bytes + this->prefix.capacity() + this->suffix.capacity();
+}
+
+}
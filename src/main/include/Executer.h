@@ -5,6 +5,8 @@
 #include "datatypes/Context.h"
 #include "processor/Preprocessor.h"
 #include "processor/Metaprocessor.h"
+#include "processor/BatchProcessor.h"
+#include "processor/Specializer.h"
 
 namespace prebyte {
 
@@ -14,7 +16,8 @@ namespace prebyte {
  * The `Executer` class serves as the entry point for triggering program execution.
  * It receives a fully prepared `Context` object (usually constructed by `ContextProcessor`)
  * and is responsible for selecting and running the appropriate processing logic
- * (e.g. `Metaprocessor` for help/version, `Preprocessor` for file processing, etc.).
+ * (e.g. `Metaprocessor` for help/version, `Preprocessor` for file processing,
+ * `BatchProcessor` for rendering one input against many rows, etc.).
  */
 class Executer {
 private:
@@ -3,13 +3,42 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <ostream>
+#include <algorithm>
+#include <functional>
+#include <memory>
 
 #include <spdlog/spdlog.h>
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 
+#include "datatypes/CancellationToken.h"
+#include "datatypes/MemoryStats.h"
+#include "datatypes/OutputSink.h"
+
 namespace prebyte {
 
+class IncrementalRenderer;
+
+/**
+ * @brief An input prepared for repeated renders, see `Prebyte::prepare()`.
+ *
+ * The handle keeps the compiled input and the output of its top-level blocks
+ * from the last render. Copies share this state.
+ */
+class RenderHandle {
+public:
+    /** @brief Returns the number of blocks the last render took from the cache. */
+    std::size_t reused_blocks() const;
+
+    /** @brief Returns the number of blocks the last render had to render. */
+    std::size_t rendered_blocks() const;
+
+private:
+    friend class Prebyte;
+    std::shared_ptr<IncrementalRenderer> renderer; ///< Compiled input and cached block output.
+};
+
 /**
  * @brief Main API class to use the Prebyte processing engine.
  *
@@ -88,6 +117,28 @@ public:
      */
     void set_rule(const std::string& rule_name, const std::string& rule_value);
 
+    /**
+     * @brief Returns the token that cancels renders of this instance.
+     * @return A copy sharing its state with the instance's token.
+     *
+     * Fetch the token before starting a render, then call `cancel()` on it from
+     * another thread to abort that render with an error. The token stays
+     * cancelled, so later renders fail as well until `reset()` is called.
+     */
+    CancellationToken cancellation_token() const;
+
+    /**
+     * @brief Returns the memory used by the last `process` or `process_file` call.
+     * @return Allocation counters and bytes retained by caches.
+     *
+     * Through the API the allocation counters only cover the render's
+     * per-render arena (transient strings and vectors of the preprocessor).
+     * Input, output, parsed `Data`, parsers and compiled templates are not
+     * counted, and `MemoryStats::complete` is `false`. `retained_bytes` is
+     * always reported.
+     */
+    MemoryStats memory_stats() const;
+
     /**
      * @brief Process an input string and return the result.
      * @param input Raw input text (e.g., with variables/macros).
@@ -118,7 +169,141 @@ public:
      */
     void process_file(const std::string& file_path, const std::string& output_path);
 
+    /**
+     * @brief Process an input string and stream the result into an output stream.
+     * @param input Raw input text.
+     * @param out Stream that receives the processed output (e.g. a file or socket stream).
+     *
+     * The output is written in chunks while processing, so no full-size copy
+     * of the result is kept in memory.
+     */
+    void process(const std::string& input, std::ostream& out);
+
+    /**
+     * @brief Process an input string and hand the result to a chunk callback.
+     * @param input Raw input text.
+     * @param sink Callback that is called with consecutive chunks of the output.
+     */
+    void process(const std::string& input, OutputSink sink);
+
+    /**
+     * @brief Process an input string and append the result to an existing string.
+     * @param input Raw input text.
+     * @param out String the output is appended to. Its capacity is reused, so
+     *            calling `out.clear()` between renders avoids reallocations.
+     */
+    void process_into(const std::string& input, std::string& out);
+
+    /**
+     * @brief Process an input string and copy the result into an output iterator.
+     * @param input Raw input text.
+     * @param out Output iterator receiving the characters (e.g. `std::back_inserter`).
+     * @return The output iterator past the last written character.
+     */
+    template <typename OutputIt>
+    OutputIt process_to(const std::string& input, OutputIt out) {
+        process(input, OutputSink([&out](std::string_view chunk) {
+            out = std::copy(chunk.begin(), chunk.end(), out);
+        }));
+        return out;
+    }
+
+    /**
+     * @brief Process an input file and stream the result into an output stream.
+     * @param file_path Path to the input file.
+     * @param out Stream that receives the processed output.
+     */
+    void process_file(const std::string& file_path, std::ostream& out);
+
+    /**
+     * @brief Process an input file and hand the result to a chunk callback.
+     * @param file_path Path to the input file.
+     * @param sink Callback that is called with consecutive chunks of the output.
+     */
+    void process_file(const std::string& file_path, OutputSink sink);
+
+    /**
+     * @brief Prepare an input for repeated renders with `render()`.
+     * @param input Raw input text.
+     * @return Handle keeping the compiled input and the output of its last render.
+     *
+     * Use this when the same input is rendered again and again with only a few
+     * variables changed in between, e.g. through `set_variable()`.
+     */
+    RenderHandle prepare(const std::string& input);
+
+    /**
+     * @brief Render a prepared input, reusing the output of blocks that did not change.
+     * @param handle Handle returned by `prepare()`.
+     * @return Processed output text, the same as `process()` would return.
+     *
+     * Top-level blocks whose variables, conditions, loop arrays and called
+     * macros have the same values as in the previous render of the handle are
+     * taken from the cache; only the others are rendered again. Changing rules,
+     * ignores or profiles drops the cache.
+     *
+     * @code
+     * RenderHandle page = prebyte.prepare(input);
+     * std::string first = prebyte.render(page);
+     * prebyte.set_variable("title", "New title");
+     * std::string second = prebyte.render(page);  // only blocks using `title` are rendered
+     * @endcode
+     */
+    std::string render(RenderHandle& handle);
+
+    /**
+     * @brief Specialize an input against variables that are constant for a deployment.
+     * @param input Raw input text.
+     * @param constants Names of the variables declared constant; all variables if empty.
+     * @return Residual template, with constant references folded, statically decided
+     *         `if`/`elif` branches removed and loops over constant arrays unrolled.
+     *
+     * Rendering the residual with the same settings gives the same output as
+     * rendering `input`; parts that cannot be decided ahead of time are kept as written.
+     */
+    std::string specialize(const std::string& input, const std::vector<std::string>& constants = {});
+
+    /**
+     * @brief Render one input once per row and return the output of every row.
+     * @param input Raw input text. It is compiled once and reused for all rows.
+     * @param rows Variable sets; each row's variables override the instance variables.
+     * @return One processed output per row, in row order.
+     *
+     * Use this for mail-merge or config-fanout jobs instead of creating one
+     * `Prebyte` instance per row. The index of a row is available as `ROW_INDEX`.
+     * Set the `batch_threads` rule to render rows in parallel.
+     */
+    std::vector<std::string> process_rows(const std::string& input, const std::vector<std::map<std::string, std::string>>& rows);
+
+    /**
+     * @brief Render one input once per row and hand the outputs to a chunk callback.
+     * @param input Raw input text.
+     * @param rows Variable sets to render the input with.
+     * @param sink Callback that is called once per row with the processed output, in row order.
+     */
+    void process_rows(const std::string& input, const std::vector<std::map<std::string, std::string>>& rows, OutputSink sink);
+
+    /**
+     * @brief Render one input once per row of a row file (e.g. CSV or a JSON array of objects).
+     * @param input Raw input text.
+     * @param rows_file Path to the row source.
+     * @return One processed output per row, in row order.
+     */
+    std::vector<std::string> process_rows_file(const std::string& input, const std::string& rows_file);
+
 private:
+    /** @brief Runs the preprocessor on the current context and takes the context back afterwards. */
+    void run();
+
+    /**
+     * @brief Renders the input once per row and takes the context back afterwards.
+     * @param input Raw input text.
+     * @param rows Variable sets to render the input with.
+     * @param callback Receives the index and output of every row, in row order.
+     */
+    void run_rows(const std::string& input, const std::vector<std::map<std::string, std::vector<std::string>>>& rows,
+                  const std::function<void(std::size_t, std::string&)>& callback);
+
     /** @brief Sets up logging based on context and settings. */
     void set_logger();
 
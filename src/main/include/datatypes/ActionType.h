@@ -22,6 +22,8 @@ namespace prebyte {
  *   - API_IN_API_OUT: Read from internal API input, write to API output.
  *   - API_IN_FILE_OUT: Read from API, write to file.
  *   - FILE_IN_API_OUT: Read from file, write to API.
+ *   - API_IN_SINK_OUT: Read from API, stream output into a caller-supplied sink.
+ *   - FILE_IN_SINK_OUT: Read from file, stream output into a caller-supplied sink.
  *
  * - Special actions:
  *   - NONE: No action specified.
@@ -46,7 +48,9 @@ enum class ActionType {
     API_IN_API_OUT,     /**< Process data via API input and produce API output. */
     API_IN_FILE_OUT,    /**< Read from API and write output to a file. */
     FILE_IN_API_OUT,    /**< Read from a file and produce output to the API. */
-    HARD_HELP           /**< Show extended help including detailed examples. */
+    HARD_HELP,          /**< Show extended help including detailed examples. */
+    API_IN_SINK_OUT,    /**< Read from API and stream output into an `OutputSink`. */
+    FILE_IN_SINK_OUT    /**< Read from a file and stream output into an `OutputSink`. */
 };
 
 }
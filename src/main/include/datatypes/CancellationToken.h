@@ -0,0 +1,34 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+namespace prebyte {
+
+/**
+ * @brief Flag that lets another thread abort a running render.
+ *
+ * Copies of a token share their state, so a caller can keep a copy, hand the
+ * other one to the engine and call `cancel()` from any thread. The render
+ * checks the flag at the same points as its resource limits and stops with
+ * an error. A cancelled token stays cancelled until `reset()` is called.
+ */
+class CancellationToken {
+public:
+    /** @brief Creates a token that is not cancelled. */
+    CancellationToken() : state(std::make_shared<std::atomic<bool>>(false)) {}
+
+    /** @brief Requests cancellation of every render that uses this token. */
+    void cancel() const { state->store(true, std::memory_order_relaxed); }
+
+    /** @brief Withdraws a cancellation, so the token can be used for further renders. */
+    void reset() const { state->store(false, std::memory_order_relaxed); }
+
+    /** @brief Checks whether cancellation was requested. */
+    bool is_cancelled() const { return state->load(std::memory_order_relaxed); }
+
+private:
+    std::shared_ptr<std::atomic<bool>> state; ///< Flag shared by all copies.
+};
+
+}
@@ -28,6 +28,10 @@ namespace prebyte {
  * - `ignore`: Rules or checks to skip.
  * - `log_level`: Desired logging verbosity ("ERROR", "WARN", "INFO", etc.).
  * - `settings_file`: Path to a custom settings/config file, if provided.
+ * - `rows_file`: Row source for multi-row rendering (CSV, JSON, YAML, ...), if provided.
+ * - `rows_output`: File name pattern for writing one output file per row, if provided.
+ * - `specialize`: Whether to write a specialized residual template instead of the output.
+ * - `constants`: Variables declared constant for specialization.
  */
 struct CliStruct {
     ActionType action;                     /**< The action to perform (e.g., HELP, FILE_IN_FILE_OUT, etc.). */
@@ -39,6 +43,10 @@ struct CliStruct {
     std::vector<std::string> ignore;       /**< Rules or checks to ignore. */
     std::string log_level = "";            /**< Logging level. */
     std::string settings_file;             /**< Optional path to a settings/configuration file. */
+    std::string rows_file;                 /**< Optional row source for multi-row rendering. */
+    std::string rows_output;               /**< Optional file name pattern for per-row output files. */
+    bool specialize = false;               /**< Specialize the input against constant variables (--specialize). */
+    std::vector<std::string> constants;    /**< Variables declared constant (--constant). */
 };
 
 }
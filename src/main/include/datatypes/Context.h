@@ -9,9 +9,13 @@
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 
+#include "datatypes/CancellationToken.h"
+#include "datatypes/IgnoreList.h"
+#include "datatypes/MemoryStats.h"
 #include "datatypes/Rules.h"
 #include "datatypes/ActionType.h"
 #include "datatypes/Profile.h"
+#include "datatypes/OutputSink.h"
 
 namespace prebyte {
 
@@ -34,32 +38,52 @@ namespace prebyte {
  * - `is_api`: Flag indicating whether the execution is API-driven (true) or CLI-driven (false).
  * - `logger`: Shared pointer to the main logger instance.
  * - `console_sink`: Sink used for colored console output.
+ * - `file_sink`: Sink writing the log file; switched off until it is needed.
  * - `rules`: All rules currently loaded and active.
  * - `input`: Primary input data (e.g., raw text or content from a file or API).
  * - `output`: Final output to be written or returned.
+ * - `output_sink`: Optional callback receiving the output in chunks while rendering.
  * - `start_time`: Timestamp of execution start, for measuring duration.
  * - `variables`: Map of variable names to their corresponding values.
  * - `inputs`: List of individual input items or sources.
- * - `ignore`: Set of rule names to skip during processing.
+ * - `ignore`: Names or glob patterns of actions to skip during processing.
  * - `profiles`: Loaded profiles mapped by their names.
  * - `macros`: Macro definitions used for rule preprocessing or template expansion.
+ * - `pure_macros`: Macros defined as `pure`, whose output only depends on their arguments.
  * - `include_counter`: Counter used to detect excessive include recursion or nesting.
+ * - `rows_source`: Row source file for multi-row rendering (empty for a single render).
+ * - `rows_output`: File name pattern for per-row output files (empty to concatenate).
+ * - `specialize`: Whether the input is specialized instead of rendered.
+ * - `constants`: Variables declared constant for specialization (empty for all variables).
+ * - `cancellation`: Token that aborts the running render when cancelled.
+ * - `memory_stats`: Memory used by the last render.
+ * - `settings_revision`: Counts API changes of rules, ignores and profiles.
  */
 struct Context {
     ActionType action_type;  /**< The selected action type (e.g., HELP, FILE_IN_FILE_OUT). */
     bool is_api = false;     /**< Indicates if the program is being run as an API call. */
     std::shared_ptr<spdlog::logger> logger; /**< Shared logger instance for writing logs. */
     std::shared_ptr<spdlog::sinks::stdout_color_sink_mt> console_sink; /**< Sink for colored console output. */
+    std::shared_ptr<spdlog::sinks::sink> file_sink; /**< Sink for the log file, switched off until it is needed. */
     Rules rules;             /**< Rules currently loaded and used during evaluation. */
     std::string input;       /**< Primary input data (could be file contents or direct string). */
     std::string output;      /**< Resulting output after processing. */
+    OutputSink output_sink;  /**< Receives output chunks for the *_SINK_OUT action types. */
     std::chrono::high_resolution_clock::time_point start_time; /**< Start timestamp of execution. */
     std::map<std::string, std::vector<std::string>> variables; /**< Map of variable names to values. */
     std::vector<std::string> inputs; /**< Individual input strings or sources. */
-    std::unordered_set<std::string> ignore; /**< Set of rule names to ignore. */
+    IgnoreList ignore; /**< Names or glob patterns of actions to ignore. */
     std::map<std::string, Profile> profiles; /**< Loaded profiles mapped by name. */
     std::map<std::string, std::string> macros; /**< Macro definitions used for templating or expansion. */
+    std::unordered_set<std::string> pure_macros; /**< Macros defined as `pure`; their calls are memoized like detected pure macros. */
     int include_counter = 0; /**< Tracks include depth or prevent infinite recursion. */
+    std::string rows_source; /**< Row source file; renders the input once per row if set. */
+    std::string rows_output; /**< Output file name pattern for multi-row rendering, rendered per row. */
+    bool specialize = false; /**< Writes a residual template specialized against constant variables instead of rendering. */
+    std::vector<std::string> constants; /**< Variables declared constant with --constant; all variables if empty. */
+    CancellationToken cancellation; /**< Aborts the running render when cancelled, e.g. from another thread. */
+    MemoryStats memory_stats; /**< Memory used by the last render, see `benchmark=MEMORY`. */
+    std::uint64_t settings_revision = 0; /**< Bumped when the API changes rules, ignores or profiles; invalidates incremental renders. */
 };
 
 /**
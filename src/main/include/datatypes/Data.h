@@ -6,11 +6,124 @@
 #include <vector>
 #include <stdexcept>
 #include <type_traits>
-#include <stdexcept>
 #include <sstream>
+#include <string_view>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
 
 namespace prebyte {
 
+class Data;
+
+/**
+ * @brief Compact string-keyed map used for the `Map` type of `Data`.
+ *
+ * Entries are stored in a single vector sorted by key instead of one
+ * heap-allocated tree node per key. Lookups use binary search, iteration
+ * is in key order (like `std::map`).
+ *
+ * Keys that are inserted in ascending order are simply appended. For
+ * bulk loading in arbitrary order, `append()` adds entries without
+ * keeping the order; the vector is sorted once on the next access. If a
+ * key was appended more than once, the last value wins.
+ *
+ * Unlike `std::map`, inserting a new key invalidates references and
+ * iterators into the map.
+ */
+class DataMap {
+public:
+    using value_type     = std::pair<std::string, Data>;           ///< Key/value entry.
+    using iterator       = std::vector<value_type>::iterator;      ///< Iterator over entries in key order.
+    using const_iterator = std::vector<value_type>::const_iterator; ///< Const iterator over entries in key order.
+
+    /** @brief Constructs an empty map. */
+    DataMap() = default;
+
+    /**
+     * @brief Constructs a map from a list of entries.
+     * @param entries Key/value pairs in any order.
+     */
+    DataMap(std::initializer_list<value_type> entries);
+
+    /**
+     * @brief Returns the value for a key, inserting a null value if the key does not exist.
+     * @param key The string key.
+     * @return Reference to the value.
+     */
+    Data& operator[](std::string_view key);
+
+    /**
+     * @brief Adds an entry without keeping the map sorted.
+     *
+     * Use this when loading many keys at once; the map is sorted on the next access.
+     *
+     * @param key The string key.
+     * @param value The value to store.
+     */
+    void append(std::string key, Data value);
+
+    /** @brief Finds the entry for a key, or returns `end()`. */
+    iterator find(std::string_view key);
+
+    /** @brief Finds the entry for a key, or returns `end()`. */
+    const_iterator find(std::string_view key) const;
+
+    /**
+     * @brief Returns the value for a key.
+     * @throws std::out_of_range if the key does not exist.
+     */
+    const Data& at(std::string_view key) const;
+
+    /** @brief Returns true if the key exists. */
+    bool contains(std::string_view key) const;
+
+    /** @brief Returns 1 if the key exists, otherwise 0. */
+    std::size_t count(std::string_view key) const;
+
+    /**
+     * @brief Removes the entry for a key.
+     * @return Number of removed entries (0 or 1).
+     */
+    std::size_t erase(std::string_view key);
+
+    /** @brief Reserves space for the given number of entries. */
+    void reserve(std::size_t size);
+
+    /** @brief Returns the number of entries. */
+    std::size_t size() const;
+
+    /** @brief Returns true if the map has no entries. */
+    bool empty() const;
+
+    /** @brief Returns an iterator to the first entry in key order. */
+    iterator begin();
+
+    /** @brief Returns an iterator past the last entry. */
+    iterator end();
+
+    /** @brief Returns an iterator to the first entry in key order. */
+    const_iterator begin() const;
+
+    /** @brief Returns an iterator past the last entry. */
+    const_iterator end() const;
+
+    /**
+     * @brief Sorts entries added with `append()` and removes duplicate keys (last value wins).
+     *
+     * Called automatically on access. `Data` calls it when a map is stored, so maps
+     * inside a `Data` tree are never modified by const access.
+     */
+    void sort() const;
+
+private:
+    mutable std::vector<value_type> entries;  ///< Entries, sorted by key unless `sorted` is false.
+    mutable bool sorted = true;               ///< False after `append()` until the next sort.
+
+    /** @brief Returns the first entry whose key is not less than the given key. */
+    const_iterator lower_bound(std::string_view key) const;
+};
+
 /**
  * @brief A dynamic data container that can hold different types of values.
  *
@@ -24,20 +137,20 @@ namespace prebyte {
  * ### Supported types:
  * - `null` (std::monostate)
  * - `std::string`
- * - `int`
+ * - `int` (stored as 64-bit integer)
  * - `double`
  * - `bool`
- * - `Map` (string to Data)
+ * - `Map` (string to Data, see `DataMap`)
  * - `Array` (vector of Data)
  */
 class Data {
 public:
     /// Map of string keys to nested Data values (like a JSON object).
-    using Map    = std::map<std::string, Data>;
+    using Map    = DataMap;
     /// Array of nested Data values (like a JSON array).
     using Array  = std::vector<Data>;
     /// Variant holding all supported data types.
-    using Value  = std::variant<std::monostate, std::string, int, double, bool, Map, Array>;
+    using Value  = std::variant<std::monostate, std::string, std::int64_t, double, bool, Map, Array>;
 
 private:
     Value value;  ///< Internal storage for the data.
@@ -53,7 +166,10 @@ public:
     Data(std::string v) : value(std::move(v)) {}
 
     /** @brief Constructs a Data object from an integer. */
-    Data(int v) : value(v) {}
+    Data(int v) : value(std::in_place_type<std::int64_t>, v) {}
+
+    /** @brief Constructs a Data object from a 64-bit integer. */
+    Data(std::int64_t v) : value(std::in_place_type<std::int64_t>, v) {}
 
     /** @brief Constructs a Data object from a double. */
     Data(double v) : value(v) {}
@@ -62,7 +178,7 @@ public:
     Data(bool v) : value(v) {}
 
     /** @brief Constructs a Data object from a Map. */
-    Data(Map v) : value(std::move(v)) {}
+    Data(Map v) : value(std::move(v)) { std::get<Map>(value).sort(); }
 
     /** @brief Constructs a Data object from an Array. */
     Data(Array v) : value(std::move(v)) {}
@@ -74,7 +190,7 @@ public:
     bool is_string() const { return std::holds_alternative<std::string>(value); }
 
     /** @brief Returns true if the stored value is an integer. */
-    bool is_int() const { return std::holds_alternative<int>(value); }
+    bool is_int() const { return std::holds_alternative<std::int64_t>(value); }
 
     /** @brief Returns true if the stored value is a double. */
     bool is_double() const { return std::holds_alternative<double>(value); }
@@ -96,10 +212,16 @@ public:
 
     /**
      * @brief Returns the value as an int.
-     * @throws std::bad_variant_access if the type is not int.
+     * @throws std::bad_variant_access if the type is not int or the value does not fit into an int.
      */
     int as_int() const;
 
+    /**
+     * @brief Returns the value as a 64-bit integer.
+     * @throws std::bad_variant_access if the type is not int.
+     */
+    std::int64_t as_int64() const;
+
     /**
      * @brief Returns the value as a double.
      * @throws std::bad_variant_access if the type is not double.
@@ -157,4 +279,32 @@ public:
     Data& operator[](size_t index);
 };
 
+inline DataMap::const_iterator DataMap::lower_bound(std::string_view key) const {
+    if (!sorted) sort();
+    return std::lower_bound(entries.cbegin(), entries.cend(), key,
+                            [](const value_type& entry, std::string_view k) { return entry.first < k; });
+}
+
+inline DataMap::iterator DataMap::find(std::string_view key) {
+    const_iterator it = lower_bound(key);
+    if (it == entries.cend() || it->first != key) return entries.end();
+    return entries.begin() + (it - entries.cbegin());
+}
+
+inline DataMap::const_iterator DataMap::find(std::string_view key) const {
+    const_iterator it = lower_bound(key);
+    if (it == entries.cend() || it->first != key) return entries.cend();
+    return it;
+}
+
+inline bool DataMap::contains(std::string_view key) const { return find(key) != end(); }
+inline std::size_t DataMap::count(std::string_view key) const { return contains(key) ? 1 : 0; }
+inline void DataMap::reserve(std::size_t size) { entries.reserve(size); }
+inline std::size_t DataMap::size() const { if (!sorted) sort(); return entries.size(); }
+inline bool DataMap::empty() const { return entries.empty(); }
+inline DataMap::iterator DataMap::begin() { if (!sorted) sort(); return entries.begin(); }
+inline DataMap::iterator DataMap::end() { return entries.end(); }
+inline DataMap::const_iterator DataMap::begin() const { if (!sorted) sort(); return entries.cbegin(); }
+inline DataMap::const_iterator DataMap::end() const { return entries.cend(); }
+
 } 
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace prebyte {
+
+/**
+ * @brief Snapshot of the process environment in a hash table.
+ *
+ * `std::getenv` scans `environ` linearly on every call. A render that
+ * resolves many `$NAME` references or unresolved names (with
+ * `allow_env_fallback`) takes one snapshot instead and looks names up in
+ * constant time. The snapshot is fixed when it is taken, so all lookups of a
+ * render see the same environment.
+ */
+class Environment {
+public:
+    /**
+     * @brief Copies the current process environment.
+     * @return Snapshot holding every `NAME=value` entry of `environ`.
+     */
+    static Environment capture();
+
+    /**
+     * @brief Looks up an environment variable.
+     * @param name Variable name without `$`.
+     * @return Pointer to the value, or `nullptr` if the variable was not set.
+     */
+    const std::string* find(std::string_view name) const;
+
+    /** @brief Returns the approximate number of bytes the snapshot occupies in memory. */
+    std::size_t memory_usage() const;
+
+private:
+    /** Hash that lets `find` look up a `std::string_view` without building a `std::string`. */
+    struct NameHash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view name) const { return std::hash<std::string_view>{}(name); }
+    };
+
+    std::unordered_map<std::string, std::string, NameHash, std::equal_to<>> values; ///< Values by variable name.
+};
+
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace prebyte {
+
+/**
+ * @brief Set of ignore patterns with compiled glob matching.
+ *
+ * Entries are plain names (`debug`) or globs where `*` matches any sequence
+ * and `?` matches a single character (`debug_*`, `*.secret`). The list keeps
+ * the patterns as entered, so it can be iterated and copied into profiles
+ * like a `std::unordered_set`.
+ *
+ * On the first lookup the patterns are compiled into a matcher: an exact
+ * name set, a set of literal suffixes for `*<suffix>` patterns, and a prefix
+ * trie for every other glob, so a lookup only tests the globs whose literal
+ * prefix matches. The result for every looked-up name is cached, so each
+ * distinct reference in a template is matched once. Changing the list drops
+ * the matcher and the cache.
+ */
+class IgnoreList {
+public:
+    using const_iterator = std::unordered_set<std::string>::const_iterator;
+
+    /** @brief Creates an empty list. */
+    IgnoreList() = default;
+
+    /**
+     * @brief Creates a list from a set of patterns.
+     * @param patterns Names or glob patterns.
+     */
+    IgnoreList(std::unordered_set<std::string> patterns);
+
+    /** @brief Adds a pattern. */
+    void insert(const std::string& pattern);
+
+    /** @brief Adds all patterns of a range. */
+    template <typename Iterator>
+    void insert(Iterator first, Iterator last) {
+        this->patterns.insert(first, last);
+        invalidate();
+    }
+
+    /** @brief Removes a pattern (the exact entry, not the names it matches). */
+    void erase(const std::string& pattern);
+
+    /**
+     * @brief Checks whether a name is matched by any pattern.
+     * @param name Variable or action name.
+     * @return `true` if the name should be ignored.
+     */
+    bool matches(const std::string& name) const;
+
+    /** @brief Returns the number of patterns. */
+    std::size_t size() const { return this->patterns.size(); }
+
+    /** @brief Checks whether the list has no patterns. */
+    bool empty() const { return this->patterns.empty(); }
+
+    /** @brief Returns an iterator to the first pattern. */
+    const_iterator begin() const { return this->patterns.begin(); }
+
+    /** @brief Returns the end iterator of the patterns. */
+    const_iterator end() const { return this->patterns.end(); }
+
+    /** @brief Compares the patterns as entered. */
+    bool operator==(const IgnoreList& other) const { return this->patterns == other.patterns; }
+
+    /**
+     * @brief Matches a name against a single glob pattern.
+     * @param pattern Pattern with `*` and `?` wildcards.
+     * @param name Name to test.
+     * @return `true` if the whole name matches the pattern.
+     */
+    static bool glob_match(std::string_view pattern, std::string_view name);
+
+private:
+    /** Patterns compiled for lookup; shared between copies, never modified after compilation. */
+    struct Matcher {
+        /** Trie node keyed by the literal prefix of a glob. */
+        struct Node {
+            std::vector<std::pair<char, std::size_t>> children;  ///< Child node index per next character.
+            std::vector<std::string> tails;                      ///< Glob remainders of patterns ending their prefix here.
+        };
+
+        std::unordered_set<std::string> exact;            ///< Patterns without wildcards.
+        std::unordered_set<std::string> suffixes;         ///< Literal parts of `*<suffix>` patterns.
+        std::vector<std::size_t> suffix_lengths;          ///< Distinct lengths in `suffixes`.
+        std::vector<Node> trie = std::vector<Node>(1);    ///< Prefix trie of all other globs; index 0 is the root.
+
+        bool matches(const std::string& name) const;
+    };
+
+    std::unordered_set<std::string> patterns;                    ///< Patterns as entered.
+    mutable std::shared_ptr<const Matcher> matcher;              ///< Compiled patterns, built on first lookup.
+    mutable std::unordered_map<std::string, bool> results;       ///< Cached lookup results per name.
+
+    /** @brief Builds the matcher from `patterns`. */
+    std::shared_ptr<const Matcher> compile() const;
+
+    /** @brief Drops the matcher and all cached results. */
+    void invalidate();
+};
+
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+
+#include <spdlog/details/file_helper.h>
+#include <spdlog/sinks/base_sink.h>
+
+namespace prebyte {
+
+/**
+ * @brief spdlog file sink that opens its file on the first log message.
+ *
+ * Behaves like `spdlog::sinks::basic_file_sink_mt` in append mode, but creating
+ * the sink costs nothing: runs that never log anything (or whose messages are
+ * all filtered out) do not touch the log file at all.
+ */
+class LazyFileSink : public spdlog::sinks::base_sink<std::mutex> {
+public:
+    /**
+     * @brief Creates the sink without opening the file.
+     * @param filename Log file, created on first use together with missing parent directories.
+     */
+    explicit LazyFileSink(std::string filename);
+
+protected:
+    /** @brief Formats a message and appends it to the log file, opening it if needed. */
+    void sink_it_(const spdlog::details::log_msg& msg) override;
+
+    /** @brief Flushes the log file if it was opened. */
+    void flush_() override;
+
+private:
+    std::string filename;                       ///< Path of the log file.
+    spdlog::details::file_helper file_helper;   ///< Open file, once the first message arrived.
+    bool opened = false;                        ///< Whether `file_helper` holds an open file.
+};
+
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace prebyte {
+
+/**
+ * @brief Memory used by a single render.
+ *
+ * Filled by a `MemoryScope` while the render runs and reported by
+ * `benchmark=MEMORY` / `benchmark=ALL` and `Prebyte::memory_stats()`.
+ *
+ * Only the CLI sees every allocation of a render. Elsewhere the counters cover
+ * the per-render arena alone, i.e. the transient strings and vectors of the
+ * `Preprocessor`, and `complete` is `false`. Scopes count a single thread, so
+ * `complete` is also `false` when `parallel_threads` rendered chunks on workers.
+ */
+struct MemoryStats {
+    std::size_t allocations = 0;     /**< Number of allocations. */
+    std::size_t allocated_bytes = 0; /**< Bytes allocated in total, including memory freed again. */
+    std::size_t peak_bytes = 0;      /**< Largest amount of memory held at the same time. */
+    std::size_t retained_bytes = 0;  /**< Bytes kept by caches (compiled templates, include store, environment) after the render. */
+    bool complete = false;           /**< True if all allocations were counted, false if only the arena or the calling thread was. */
+};
+
+/**
+ * @brief Counts the allocations of the current thread while it is alive.
+ *
+ * Allocations are reported through `allocated()` and `deallocated()`. The
+ * `CountingResource` does so for everything allocated through it; the CLI
+ * binary additionally reports every `operator new` of the thread, so there a
+ * scope sees all memory of a render, including parsers and `Data`. Scopes
+ * nest; only the innermost one counts.
+ */
+class MemoryScope {
+public:
+    /**
+     * @brief Starts counting into `stats`.
+     * @param stats Receives the counters; must outlive the scope.
+     */
+    explicit MemoryScope(MemoryStats& stats);
+
+    /** @brief Stops counting and reactivates the enclosing scope, if any. */
+    ~MemoryScope();
+
+    MemoryScope(const MemoryScope&) = delete;
+    MemoryScope& operator=(const MemoryScope&) = delete;
+
+    /** @brief Records an allocation of `bytes` in the active scope of this thread, if any. */
+    static void allocated(std::size_t bytes) noexcept;
+
+    /** @brief Records that `bytes` were freed in the active scope of this thread, if any. */
+    static void deallocated(std::size_t bytes) noexcept;
+
+    /** @brief Checks whether a scope is counting on this thread. */
+    static bool is_active() noexcept { return active != nullptr; }
+
+    /**
+     * @brief Declares that every `operator new` of the process is reported.
+     *
+     * Called once at startup by binaries that replace the global allocation
+     * functions. `CountingResource` then stops reporting on its own, since its
+     * memory comes from `operator new` and would be counted twice.
+     */
+    static void set_counts_operator_new();
+
+    /** @brief Checks whether every `operator new` of the process is reported. */
+    static bool counts_operator_new();
+
+private:
+    MemoryStats& stats;          ///< Counters of this scope.
+    std::size_t current = 0;     ///< Bytes allocated in this scope and not yet freed.
+    MemoryScope* previous;       ///< Scope that was active before this one.
+
+    static thread_local MemoryScope* active; ///< Innermost scope of the current thread.
+    static bool operator_new_counted;        ///< Whether `operator new` reports to the scopes.
+};
+
+/**
+ * @brief `std::pmr` memory resource that reports its allocations to the active `MemoryScope`.
+ */
+class CountingResource : public std::pmr::memory_resource {
+public:
+    /**
+     * @brief Creates a resource forwarding to `upstream`.
+     * @param upstream Resource that provides the memory.
+     */
+    explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) : upstream(upstream) {}
+
+private:
+    std::pmr::memory_resource* upstream; ///< Resource that provides the memory.
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+}
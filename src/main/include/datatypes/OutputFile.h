@@ -0,0 +1,76 @@
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <ostream>
+#include <string_view>
+
+namespace prebyte {
+
+/**
+ * @brief Output file that is replaced atomically.
+ *
+ * Content is written to a temporary file next to the target, which is renamed
+ * over the target on `commit()`. Readers see either the old or the complete
+ * new file, never a partly written one. If the target exists, its permissions
+ * are kept; a symlinked target is replaced at the file the link points to.
+ *
+ * With `skip_unchanged`, an existing target whose content equals the new output
+ * is left alone, so its modification time does not change. Sizes are compared
+ * first; only files of equal size are compared byte by byte.
+ */
+class OutputFile {
+public:
+    /**
+     * @brief Opens a temporary file for a target.
+     * @param path Target file.
+     * @param skip_unchanged Whether `commit()` keeps a target with the same content.
+     * @throws std::runtime_error if the temporary file cannot be created.
+     */
+    OutputFile(const std::filesystem::path& path, bool skip_unchanged);
+
+    /** @brief Removes the temporary file unless it was committed. */
+    ~OutputFile();
+
+    OutputFile(const OutputFile&) = delete;
+    OutputFile& operator=(const OutputFile&) = delete;
+
+    /** @brief Returns the stream writing into the temporary file. */
+    std::ostream& stream() { return this->out; }
+
+    /**
+     * @brief Replaces the target with the written content.
+     * @return `true` if the target was replaced, `false` if it was kept because it was unchanged.
+     * @throws std::runtime_error if writing or renaming fails.
+     */
+    bool commit();
+
+    /**
+     * @brief Writes a complete output to a file.
+     *
+     * With `skip_unchanged`, the target is compared before anything is written.
+     *
+     * @param path Target file.
+     * @param content Output to write.
+     * @param skip_unchanged Whether to keep a target with the same content.
+     * @return `true` if the target was written, `false` if it was unchanged.
+     * @throws std::runtime_error if writing fails.
+     */
+    static bool write(const std::filesystem::path& path, std::string_view content, bool skip_unchanged);
+
+private:
+    std::filesystem::path target;     ///< File that is replaced on commit.
+    std::filesystem::path temp_path;  ///< Temporary file receiving the output.
+    std::ofstream out;                ///< Stream into `temp_path`.
+    bool skip_unchanged;              ///< Whether an unchanged target is kept.
+    bool committed = false;           ///< Whether the temporary file was renamed or removed.
+
+    /**
+     * @brief Checks whether a file has exactly the given content.
+     * @param path File to check; a missing file never matches.
+     * @param content Expected content.
+     */
+    static bool has_content(const std::filesystem::path& path, std::string_view content);
+};
+
+}
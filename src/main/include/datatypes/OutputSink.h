@@ -0,0 +1,21 @@
+#pragma once
+
+#include <functional>
+#include <string_view>
+
+namespace prebyte {
+
+/**
+ * @brief Callback that receives rendered output in chunks.
+ *
+ * An `OutputSink` is handed the processed text piece by piece while a render
+ * is running, instead of receiving one fully assembled string at the end.
+ * This lets callers stream directly into a socket, file or their own buffer
+ * and control allocation themselves.
+ *
+ * The `std::string_view` passed to the sink is only valid for the duration
+ * of the call; copy the data if it needs to outlive the callback.
+ */
+using OutputSink = std::function<void(std::string_view)>;
+
+}
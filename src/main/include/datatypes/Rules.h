@@ -1,9 +1,11 @@
 #pragma once
 
 #include <spdlog/common.h>
+#include <cstdint>
 #include <string>
 #include <optional>
 #include <filesystem>
+#include <vector>
 
 #include <spdlog/spdlog.h>
 
@@ -47,8 +49,17 @@ struct Rules {
     std::optional<std::string> default_variable_value; /**< Value to use when a variable is missing and defaulting is enabled. */
     std::optional<std::string> variable_prefix;  /**< Optional prefix for variables (e.g., `$`). */
     std::optional<std::string> variable_suffix;  /**< Optional suffix for variables (e.g., `}` or `]`). */
-    std::optional<std::string> include_path;     /**< Directory path used to resolve includes. */
+    std::optional<std::string> include_path;     /**< ':'-separated directories used to resolve includes. */
     std::optional<Benchmark> benchmark;          /**< Benchmarking mode (time, memory, both, or none). */
+    std::optional<int> batch_threads;            /**< Threads used to render rows in multi-row mode (0 = all cores). */
+    std::optional<int> parallel_threads;         /**< Threads used to render chunks of a single input (1 = off, 0 = all cores). */
+    std::optional<std::int64_t> max_output_size; /**< Maximum output size of a render in bytes (0 = unlimited). */
+    std::optional<std::int64_t> max_loop_iterations; /**< Maximum for loop iterations of a render (0 = unlimited). */
+    std::optional<int> max_include_depth;        /**< Maximum nesting of includes; also bounds native stack use of includes inside for loops. */
+    std::optional<int> max_macro_depth;          /**< Maximum nesting of macro calls; also bounds native stack use of calls inside for loops. */
+    std::optional<std::int64_t> render_timeout_ms; /**< Wall-time budget of a render in milliseconds (0 = unlimited). */
+    std::optional<bool> skip_unchanged_output;   /**< Keeps an output file untouched if its content would not change. */
+    std::optional<int> macro_cache_size;         /**< Results of pure macro calls kept per render (0 = no memoization). */
 
     /**
      * @brief Registers a rule from its name and associated data.
@@ -77,6 +88,14 @@ struct Rules {
      */
     int get_int(Data data);
 
+    /**
+     * @brief Extracts a 64-bit integer from a `Data` object.
+     * @param data The data to extract from.
+     * @return The integer value.
+     * @throws std::runtime_error if the value is not an integer.
+     */
+    std::int64_t get_int64(Data data);
+
     /**
      * @brief Extracts a double from a `Data` object.
      * @param data The data to extract from.
@@ -85,12 +104,24 @@ struct Rules {
      */
     double get_double(Data data);
 
+    /**
+     * @brief Returns the include search directories in lookup order.
+     *
+     * `include_path` holds one or more directories separated by `:`. A leading `~`
+     * of each entry is expanded here, so `HOME` is only read once an include
+     * actually needs it. Empty entries are skipped.
+     */
+    std::vector<std::filesystem::path> get_include_dirs() const;
+
     /**
      * @brief Initializes or resets the internal state of the ruleset.
      *
      * This function can be used to apply defaults or clear previously set values.
      */
     void init();
+
+    /** @brief Compares all rule values. */
+    bool operator==(const Rules& other) const = default;
 };
 
 
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace prebyte {
+
+/**
+ * @brief Computes the 64-bit FNV-1a hash of a byte sequence.
+ *
+ * Used to recognize unchanged or identical file contents. It is fast, not
+ * cryptographic; callers that must not confuse two inputs compare the bytes
+ * when hashes are equal.
+ *
+ * @param content Bytes to hash.
+ * @return The hash value.
+ */
+inline std::uint64_t hash_content(std::string_view content) {
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : content) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+}
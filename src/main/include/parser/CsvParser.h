@@ -1,11 +1,10 @@
 #pragma once
 
-#include <fstream>
-#include <sstream>
+#include <charconv>
 #include <stdexcept>
 #include <vector>
-#include <algorithm>
 #include "parser/Parser.h"
+#include "parser/CsvReader.h"
 
 namespace prebyte {
 
@@ -17,6 +16,26 @@ public:
     Data parse(const std::filesystem::path& filepath) override;
     bool can_parse(const std::filesystem::path& filepath) const override;
     Data parse_string(const std::string& csv_string) override;
+
+    /**
+     * @brief Converts a CSV field into a typed value.
+     *
+     * `true`/`false` become booleans, whole numbers integers and decimal
+     * numbers doubles. Everything else stays a string.
+     *
+     * @param field The raw field.
+     * @return The converted value.
+     */
+    static Data convert_field(const std::string& field);
+
+private:
+    /**
+     * @brief Reads the header and all records into an array of maps.
+     * @param reader Reader positioned at the header record.
+     * @param source Description of the input for error messages.
+     * @return One map per record, keyed by the header names.
+     */
+    Data read_rows(CsvReader& reader, const std::string& source);
 };
 
 }
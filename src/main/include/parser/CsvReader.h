@@ -0,0 +1,85 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <filesystem>
+#include <stdexcept>
+
+#include "parser/MappedFile.h"
+
+namespace prebyte {
+
+/**
+ * @brief Streaming reader for CSV records (RFC 4180).
+ *
+ * The reader walks over a memory-mapped file (or a string) and returns one
+ * record at a time, so files of any size can be processed without holding
+ * all rows in memory.
+ *
+ * Supported syntax:
+ * - Fields separated by `,` and records separated by LF or CRLF.
+ * - Fields enclosed in double quotes may contain separators, line breaks and
+ *   escaped quotes (`""`).
+ * - Empty lines between records are skipped.
+ *
+ * Separators, quotes and line breaks are searched 16 bytes at a time with
+ * SSE2 where available.
+ */
+class CsvReader {
+public:
+    /**
+     * @brief Opens a CSV file.
+     * @param filepath Path to the file.
+     * @throws std::runtime_error if the file cannot be opened.
+     */
+    explicit CsvReader(const std::filesystem::path& filepath);
+
+    /**
+     * @brief Reads CSV records from a string.
+     * @param input CSV content; must outlive the reader.
+     */
+    explicit CsvReader(std::string_view input);
+
+    /**
+     * @brief Reads the next record.
+     *
+     * Strings already in `fields` are reused, so passing the same vector for
+     * every record avoids allocations for fields of similar size.
+     *
+     * @param fields Receives the fields of the record.
+     * @return `false` if there are no more records.
+     * @throws std::runtime_error if a quoted field is not closed.
+     */
+    bool next(std::vector<std::string>& fields);
+
+    /** @brief Returns the number of records read so far. */
+    std::size_t get_record_count() const { return record_count; }
+
+private:
+    MappedFile file;            ///< Mapping of the input file, if reading from a file.
+    std::string_view input;     ///< Remaining input.
+    std::size_t position = 0;   ///< Offset of the next unread character.
+    std::size_t record_count = 0; ///< Number of records read.
+
+    /**
+     * @brief Finds the next separator, quote or line break.
+     * @param position Offset to start searching at.
+     * @return Offset of the character, or the input size if there is none.
+     */
+    std::size_t find_special(std::size_t position) const;
+
+    /**
+     * @brief Reads an unquoted field, or the rest of a field after its closing quote.
+     * @param field String the characters are appended to.
+     */
+    void read_plain(std::string& field);
+
+    /**
+     * @brief Reads a quoted field; `position` must point at the opening quote.
+     * @param field String the unescaped content is appended to.
+     */
+    void read_quoted(std::string& field);
+};
+
+}
@@ -2,6 +2,8 @@
 
 #include <string>
 #include <filesystem>
+#include <fstream>
+#include <optional>
 
 #include "datatypes/Data.h"
 #include "parser/Parser.h"
@@ -25,6 +27,10 @@ namespace prebyte {
  *
  * This class abstracts away file I/O and parsing logic to simplify usage
  * elsewhere in the application.
+ *
+ * The format is detected from the file extension. Files with an unknown
+ * extension are detected by sniffing their first bytes. Every file is
+ * parsed exactly once; invalid content is reported by the parser itself.
  */
 class FileParser {
 public:
@@ -44,6 +50,28 @@ public:
      */
     Data parse(const std::string& filePath);
 
+    /**
+     * @brief Returns the shared parser instance for a format.
+     *
+     * Parsers are stateless, so one instance per format is created on first
+     * use and reused for every file and string afterwards.
+     *
+     * @param parserType The format to parse.
+     * @return Reference to the parser.
+     */
+    static Parser& get_parser(ParserType parserType);
+
+    /**
+     * @brief Detects the format of a file.
+     *
+     * The extension is checked first. For unknown extensions the first bytes
+     * of the file are inspected (e.g. `{` for JSON, `<` for XML, `---` for YAML).
+     *
+     * @param filePath Path to the file.
+     * @return The detected format, or `std::nullopt` if it cannot be detected.
+     */
+    static std::optional<ParserType> detect_type(const std::filesystem::path& filePath);
+
 private:
     /**
      * @brief Internal helper to parse the file using a specified parser.
@@ -52,10 +80,17 @@ private:
      * instance, such as a JSON or YAML parser.
      *
      * @param filePath The path to the file being parsed.
-     * @param parser Pointer to the parser to use.
+     * @param parser The parser to use.
      * @return Parsed `Data` structure.
      */
-    Data parseFile(const std::string& filePath, Parser* parser);
+    Data parseFile(const std::string& filePath, Parser& parser);
+
+    /**
+     * @brief Detects the format from the first bytes of a file.
+     * @param filePath Path to the file.
+     * @return The detected format, or `std::nullopt` if the content is not recognized.
+     */
+    static std::optional<ParserType> sniff_type(const std::filesystem::path& filePath);
 };
 
 }
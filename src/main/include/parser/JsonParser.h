@@ -1,20 +1,39 @@
 #pragma once
 
 #include <fstream>
+#include <functional>
 #include <nlohmann/json.hpp>
 
 #include "parser/Parser.h"
+#include "parser/MappedFile.h"
 
 namespace prebyte {
 
 class JsonParser : public Parser {
 public:
+    /// Receives one element of a streamed JSON array or JSON Lines file. Return `false` to stop.
+    using ElementCallback = std::function<bool(Data&)>;
+
     JsonParser() = default;
     ~JsonParser() override = default;
 
     Data parse(const std::filesystem::path& filepath) override;
     bool can_parse(const std::filesystem::path& filepath) const override;
     Data parse_string(const std::string& json_string) override;
+
+    /**
+     * @brief Streams the elements of a JSON file one at a time.
+     *
+     * For a top-level array, each element is handed to the callback as soon as
+     * it is parsed and released afterwards, so the whole array is never held in
+     * memory. Files ending in `.jsonl` or `.ndjson` are read as JSON Lines (one
+     * value per line). Any other top-level value is passed as a single element.
+     *
+     * @param filepath Path to the JSON or JSON Lines file.
+     * @param callback Called for every element.
+     * @throws std::runtime_error if the file cannot be read or is not valid JSON.
+     */
+    static void for_each_element(const std::filesystem::path& filepath, const ElementCallback& callback);
 };
 
 }
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <filesystem>
+#include <stdexcept>
+
+namespace prebyte {
+
+/**
+ * @brief Read-only view of a whole file.
+ *
+ * On POSIX systems the file is memory-mapped, so large inputs are paged in by
+ * the operating system on demand instead of being copied into a string first.
+ * On other systems the file is read into an internal buffer.
+ *
+ * The view returned by `view()` stays valid as long as the `MappedFile` exists.
+ */
+class MappedFile {
+public:
+    /** @brief Creates an empty mapping. */
+    MappedFile() = default;
+
+    /**
+     * @brief Maps a file into memory.
+     * @param filepath Path to the file.
+     * @throws std::runtime_error if the file cannot be opened or mapped.
+     */
+    explicit MappedFile(const std::filesystem::path& filepath);
+
+    /** @brief Unmaps the file. */
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /** @brief Takes over the mapping of another instance. */
+    MappedFile(MappedFile&& other) noexcept;
+
+    /** @brief Takes over the mapping of another instance. */
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /** @brief Returns the file content. */
+    std::string_view view() const { return std::string_view(data, size); }
+
+private:
+    const char* data = nullptr;  ///< Start of the mapped content.
+    std::size_t size = 0;        ///< Size of the content in bytes.
+    bool mapped = false;         ///< True if `data` must be unmapped on destruction.
+    std::string buffer;          ///< Content if the file could not be mapped.
+
+    /** @brief Releases the mapping, if any. */
+    void release();
+};
+
+}
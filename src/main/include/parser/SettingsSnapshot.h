@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "datatypes/Profile.h"
+
+namespace prebyte {
+
+/**
+ * @brief Binary snapshot of a fully processed settings file.
+ *
+ * Parsing a settings file and walking the resulting `Data` tree costs far more
+ * than the templating of a small input. After the first run, the processed
+ * variables, profiles, ignore items and rules are written to a compact binary
+ * file in `~/.prebyte/cache`, named after a hash of the canonical path of the
+ * source. Later runs memory-map that file and read it back without parsing.
+ *
+ * A snapshot is only used while the size and modification time of its source
+ * match the recorded values. If only the modification time differs, the source
+ * content is hashed and compared, so touching a file does not discard it.
+ */
+class SettingsSnapshot {
+public:
+    /** @brief Size, modification time and content hash of a settings file. */
+    struct SourceStamp {
+        std::uint64_t size = 0;   ///< File size in bytes.
+        std::int64_t mtime = 0;   ///< Modification time as a raw clock count.
+        std::uint64_t hash = 0;   ///< `hash_content` of the file.
+    };
+
+    std::map<std::string, std::vector<std::string>> variables;  ///< Variables from the `variables` section.
+    std::map<std::string, Profile> profiles;                     ///< Profiles from the `profiles` section.
+    std::unordered_set<std::string> ignore;                      ///< Items from the `ignore` section.
+    std::map<std::string, std::string> rules;                    ///< Rules from the `rules` section.
+
+    /**
+     * @brief Returns the snapshot file used for a settings file.
+     * @param source Path to the settings file.
+     * @return Path of the snapshot in `~/.prebyte/cache`, or an empty path if `HOME` is not set.
+     */
+    static std::filesystem::path path_for(const std::filesystem::path& source);
+
+    /**
+     * @brief Reads the stamp of a settings file.
+     *
+     * Take it before parsing the file, so a change made while parsing makes the
+     * snapshot outdated instead of recording the new stamp for the old content.
+     *
+     * @param source Path to the settings file.
+     * @throws std::filesystem::filesystem_error if the file cannot be read.
+     */
+    static SourceStamp stamp(const std::filesystem::path& source);
+
+    /**
+     * @brief Loads the snapshot of a settings file if it is still valid.
+     * @param source Path to the settings file.
+     * @return The snapshot, or `std::nullopt` if it is missing, outdated or damaged.
+     */
+    static std::optional<SettingsSnapshot> load(const std::filesystem::path& source);
+
+    /**
+     * @brief Writes the snapshot for a settings file.
+     *
+     * The file is written to a temporary name first and then renamed, so
+     * concurrent runs never read a partially written snapshot.
+     *
+     * @param source Path to the settings file the snapshot was built from.
+     * @param stamp Stamp of the source, taken before it was parsed.
+     * @throws std::runtime_error if the snapshot cannot be written.
+     */
+    void save(const std::filesystem::path& source, const SourceStamp& stamp) const;
+};
+
+}
@@ -8,6 +8,7 @@
 #include "parser/YamlParser.h"
 #include "parser/XmlParser.h"
 #include "parser/TomlParser.h"
+#include "parser/FileParser.h"
 
 namespace prebyte {
 
@@ -51,17 +52,6 @@ public:
      * @throws std::invalid_argument if the name is not recognized.
      */
     ParserType getParserType(const std::string& parserName) const;
-
-private:
-    /**
-     * @brief Internal helper that delegates parsing to a specific parser instance.
-     *
-     * @param input The input string to parse.
-     * @param parser Pointer to a parser implementation.
-     * @return Parsed `Data` object.
-     * @throws std::runtime_error on failure.
-     */
-    Data parseFile(const std::string& input, Parser* parser);
 };
 
 }
@@ -3,6 +3,7 @@
 
 #include <pugixml.hpp>
 #include <fstream>
+#include <functional>
 
 #include "parser/Parser.h"
 
@@ -10,12 +11,28 @@ namespace prebyte {
 
 class XmlParser : public Parser {
 public:
+    /// Receives one child element of the XML root. Return `false` to stop.
+    using ElementCallback = std::function<bool(Data&)>;
+
     XmlParser() = default;
     ~XmlParser() override = default;
 
     Data parse(const std::filesystem::path& filepath) override;
     bool can_parse(const std::filesystem::path& filepath) const override;
     Data parse_string(const std::string& xml_string) override;
+
+    /**
+     * @brief Streams the child elements of the XML root one at a time.
+     *
+     * Each element below the document element (for example every `<item>` of
+     * a catalogue) is converted and handed to the callback on its own, so the
+     * `Data` tree for the whole document is never built.
+     *
+     * @param filepath Path to the XML file.
+     * @param callback Called for every child element of the root.
+     * @throws std::runtime_error if the file cannot be parsed.
+     */
+    static void for_each_element(const std::filesystem::path& filepath, const ElementCallback& callback);
 };
 
 }
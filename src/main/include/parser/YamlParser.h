@@ -4,7 +4,10 @@
 #include <yaml-cpp/yaml.h>
 #include <fstream>
 #include <stdexcept>
-#include <regex>
+#include <charconv>
+#include <optional>
+#include <limits>
+#include <cctype>
 
 #include "parser/Parser.h"
 #include "datatypes/Data.h"
@@ -19,6 +22,18 @@ public:
         Data parse(const std::filesystem::path& filepath) override;
         bool can_parse(const std::filesystem::path& filepath) const override;
         Data parse_string(const std::string& yaml_string) override;
+
+        /**
+         * @brief Resolves a plain YAML scalar following the YAML 1.2 core schema.
+         *
+         * Recognizes null, booleans, decimal/hex (`0x`)/octal (`0o`) integers in
+         * 64-bit range, floats with exponents and `.inf`/`.nan`. Everything else
+         * stays a string.
+         *
+         * @param value The scalar text.
+         * @return The typed value.
+         */
+        static Data convert_scalar(const std::string& value);
 };
 
 }
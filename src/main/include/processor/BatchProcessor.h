@@ -0,0 +1,101 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <functional>
+#include <memory>
+
+#include "processor/Processor.h"
+#include "processor/Preprocessor.h"
+#include "processor/Template.h"
+#include "parser/FileParser.h"
+#include "datatypes/Context.h"
+#include "datatypes/Data.h"
+
+namespace prebyte {
+
+/**
+ * @brief Renders one input against many variable sets (rows).
+ *
+ * The `BatchProcessor` is used for mail-merge or config-fanout jobs, where the same
+ * input is rendered once per row of a row source (e.g. a CSV file or a JSON array of
+ * objects). The input is read and compiled into a `Template` a single time; every row
+ * is then rendered from that template with the row's variables bound on top of the
+ * variables of the context.
+ *
+ * Every thread renders its rows with one `Preprocessor` on its own copy of the context:
+ * the row's variables are bound before and restored after each row. Only a row that
+ * changes the context otherwise (e.g. with `set var`) makes the next row start from a
+ * fresh copy.
+ *
+ * Rows can be rendered in parallel (see the `batch_threads` rule). Rendered rows are
+ * always handed on in row order, either concatenated into the normal output or written
+ * to one file per row using the `rows_output` name pattern.
+ */
+class BatchProcessor : public Processor {
+public:
+    using Row = std::map<std::string, std::vector<std::string>>;             ///< Variables of a single row.
+    using RowCallback = std::function<void(std::size_t, std::string&)>;    ///< Receives the index and output of a rendered row.
+
+    /**
+     * @brief Constructs a `BatchProcessor` from a given context.
+     * @param context Execution context containing configuration, rules, and variables shared by all rows.
+     */
+    BatchProcessor(std::unique_ptr<Context> context);
+
+    /**
+     * @brief Renders the CLI input once for every row of the context's row source.
+     *
+     * Reads the input and the row source, renders all rows and writes the output
+     * to standard output, the output file or one file per row.
+     */
+    void process() override;
+
+    /**
+     * @brief Renders an input once per row.
+     * @param input Raw input text; compiled only once for all rows.
+     * @param rows Variable sets to render the input with.
+     * @param callback Called in row order with the index and rendered output of each row.
+     */
+    void render_rows(const std::string& input, const std::vector<Row>& rows, const RowCallback& callback);
+
+    /**
+     * @brief Converts parsed row data into variable sets.
+     * @param data An array of maps, as produced by `FileParser` for CSV or JSON arrays.
+     * @return One variable set per row.
+     * @throws std::runtime_error if the data is not an array of maps with scalar or list values.
+     */
+    static std::vector<Row> get_rows(const Data& data);
+
+private:
+    /**
+     * @brief Renders a compiled template against a single row.
+     *
+     * Errors throw instead of ending the program, as rows may be rendered on worker threads.
+     *
+     * @param preprocessor Preprocessor of the calling thread; created on first use and reset if the row changed its context.
+     * @param compiled The compiled template.
+     * @param row Variables of the row.
+     * @param index Index of the row, available as `ROW_INDEX`.
+     * @return The rendered output.
+     */
+    std::string render_row(std::unique_ptr<Preprocessor>& preprocessor, const Template& compiled, const Row& row, std::size_t index) const;
+
+    /**
+     * @brief Returns the number of threads to use for the given number of rows.
+     * @param row_count Number of rows to render.
+     * @return Number of threads (at least 1).
+     */
+    std::size_t get_thread_count(std::size_t row_count) const;
+
+    /**
+     * @brief Writes a rendered row into its own file.
+     * @param path Output path, rendered from the `rows_output` pattern.
+     * @param output Rendered output of the row.
+     * @throws std::runtime_error if the path is empty or the file cannot be written.
+     */
+    void write_row_file(const std::filesystem::path& path, const std::string& output) const;
+};
+
+}
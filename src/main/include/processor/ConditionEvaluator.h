@@ -0,0 +1,71 @@
+#pragma once
+
+#include <functional>
+#include <optional>
+#include <string>
+
+namespace prebyte {
+
+/**
+ * @brief Parses and evaluates the conditions of `if` and `elif`.
+ *
+ * A condition combines comparisons (`a == "x"`, `a != b`) and existence checks
+ * (`a`) with `||`, `&&`, `!` and parentheses. Variables are resolved by a
+ * callback that may leave them unknown. The `ProcessingFlow` knows every
+ * variable and gets a plain result; the `Specializer` only knows its constants
+ * and gets the condition with the known parts folded away.
+ */
+class ConditionEvaluator {
+public:
+    /** @brief A variable of a condition as seen by the resolver. */
+    struct Operand {
+        std::optional<bool> defined;  ///< Whether the variable is defined, or nothing if that is not known.
+        std::string value{};          ///< Value used in comparisons if `defined` is known; empty for undefined variables.
+        std::string residual{};       ///< Text standing for the variable in a residual condition.
+    };
+
+    /** @brief A (partially) evaluated condition. */
+    struct Result {
+        std::optional<bool> value;    ///< The result, if it does not depend on unknown variables.
+        std::string residual{};       ///< The condition to evaluate later otherwise.
+    };
+
+    /** @brief Resolves a variable name to an `Operand`. */
+    using Resolver = std::function<Operand(const std::string&)>;
+
+    /**
+     * @brief Creates an evaluator.
+     * @param resolver Resolves the variables of a condition.
+     */
+    explicit ConditionEvaluator(Resolver resolver) : resolver(std::move(resolver)) {}
+
+    /**
+     * @brief Evaluates a condition.
+     * @param expr The condition, e.g. `name == "ada" && !debug`.
+     * @return The result, or the residual condition if it depends on unknown variables.
+     */
+    Result evaluate(const std::string& expr) const;
+
+    /** @brief Trims spaces and tabs from both ends of a string. */
+    static std::string trim(const std::string& s);
+
+private:
+    Resolver resolver;  ///< Resolves the variables of a condition.
+
+    /** @brief Evaluates an OR expression. */
+    Result evaluate_or(const std::string& expr) const;
+
+    /** @brief Evaluates an AND expression. */
+    Result evaluate_and(const std::string& expr) const;
+
+    /** @brief Evaluates a NOT or parenthesized expression. */
+    Result evaluate_not(const std::string& expr) const;
+
+    /** @brief Evaluates a comparison or an existence check. */
+    Result evaluate_comparison(const std::string& expr) const;
+
+    /** @brief Resolves a comparison operand, which is a variable name or a string literal. */
+    Operand resolve_operand(const std::string& token) const;
+};
+
+}
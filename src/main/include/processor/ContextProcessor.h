@@ -6,9 +6,11 @@
 #include "datatypes/CliStruct.h"
 #include "datatypes/Context.h"
 #include "datatypes/Data.h"
+#include "datatypes/LazyFileSink.h"
 #include "datatypes/Profile.h"
 #include "datatypes/Rules.h"
 #include "parser/FileParser.h"
+#include "parser/SettingsSnapshot.h"
 
 namespace prebyte {
 
@@ -32,9 +34,22 @@ private:
     /** @brief Determines the action type to be executed based on CLI state. */
     void determine_action_type();
 
+    /**
+     * @brief Checks whether the selected action depends on settings, profiles or CLI variables.
+     *
+     * Help, explain and version output never do, so their startup skips the settings file.
+     */
+    bool needs_settings() const;
+
     /** @brief Loads and applies settings from the settings file or defaults. */
     void load_settings();
 
+    /**
+     * @brief Moves processed settings into the context and applies their rules.
+     * @param settings Settings read from the settings file or its snapshot.
+     */
+    void apply_settings(SettingsSnapshot& settings);
+
     /** @brief Loads profile definitions from CLI or settings. */
     void load_profiles();
 
@@ -97,9 +112,16 @@ private:
      */
     std::map<std::string, std::string> get_rules(const Data& rules);
 
-    /** @brief Initializes the logger based on CLI or settings. */
+    /**
+     * @brief Initializes the logger based on CLI or settings.
+     *
+     * The log file sink starts switched off, so help and version output never open the log file.
+     */
     void set_logger();
 
+    /** @brief Switches on the log file sink once the action reads settings or renders. */
+    void enable_file_log();
+
     /**
      * @brief Expands `~` in file paths to the user's home directory.
      * @param path Path that may contain `~`.
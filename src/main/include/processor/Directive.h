@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace prebyte {
+
+/**
+ * @brief Enumeration of supported flow control and transformation actions.
+ *
+ * `FlowType` defines all recognized preprocessing actions that the engine can execute,
+ * including setting variables, profiles, macros, conditionals, loops, and includes.
+ */
+enum class FlowType {
+    NONE,            /**< The action is not a directive (e.g. a variable). */
+    SET_VAR,         /**< Sets a variable to a value. */
+    UNSET_VAR,       /**< Removes a variable from the current scope. */
+    SET_RULE,        /**< Adds or overrides a rule. */
+    DEFINE_PROFILE,  /**< Starts a new profile definition block. */
+    SET_PROFILE,     /**< Applies an existing profile to the current context. */
+    UNSET_PROFILE,   /**< Removes an active profile from context. */
+    SET_IGNORE,      /**< Adds entries to the ignore list. */
+    UNSET_IGNORE,    /**< Removes entries from the ignore list. */
+    DEFINE_MACRO,    /**< Begins definition of a new macro. */
+    END_DEFINE,      /**< Marks the end of a macro or profile definition. */
+    EXECUTE_MACRO,   /**< Executes a previously defined macro. */
+    IF,              /**< Starts an IF conditional block. */
+    ELSE_IF,         /**< Starts an ELSE IF condition. */
+    ELSE,            /**< Starts an ELSE block. */
+    ENDIF,           /**< Ends an IF/ELSE control block. */
+    FOR,             /**< Starts a FOR loop block. */
+    ENDFOR,          /**< Ends a FOR loop block. */
+    INCLUDE,         /**< Includes and processes an external file. */
+    INCLUDE_ONCE     /**< Includes a file unless its content was already included in this render. */
+};
+
+/**
+ * @brief A directive keyword recognized in an action, such as `set var` or `endif`.
+ *
+ * Classification looks at the first character and the keyword length, so it costs
+ * a few comparisons and never allocates. The arguments are not copied; only their
+ * offset in the action is stored, which keeps a `Directive` valid when the action
+ * string it was parsed from is copied or moved. `Template::compile` classifies every
+ * action once, so rendering the same template again does not repeat the work.
+ */
+struct Directive {
+    FlowType type = FlowType::NONE;  /**< The recognized directive, or `NONE`. */
+    std::size_t args_offset = 0;     /**< Offset of the arguments within the action. */
+
+    /**
+     * @brief Classifies an action.
+     * @param action Action text without prefix and suffix (e.g. `set var name=value`).
+     * @return The directive; `type` is `FlowType::NONE` if the action is not a directive.
+     */
+    static Directive parse(std::string_view action);
+
+    /**
+     * @brief Returns the arguments of the directive.
+     * @param action The action this directive was parsed from.
+     * @return Everything after the keywords (e.g. `name=value`).
+     */
+    std::string_view arguments(std::string_view action) const { return action.substr(args_offset); }
+
+    /** @brief Checks whether this directive opens, continues or closes a conditional block. */
+    bool is_conditional() const {
+        return type == FlowType::IF || type == FlowType::ELSE_IF || type == FlowType::ELSE || type == FlowType::ENDIF;
+    }
+};
+
+}
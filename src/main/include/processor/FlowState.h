@@ -29,7 +29,8 @@ enum class FlowState {
     FOR,            /**< Entering a `for` loop block. */
     END_FOR,        /**< Ending a `for` loop block. */
 
-    INCLUDE         /**< Processing an `include` directive. */
+    INCLUDE,        /**< Processing an `include` directive. */
+    INCLUDE_ONCE    /**< Processing an `include_once` directive. */
 };
 
 }
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "datatypes/Rules.h"
+
+namespace prebyte {
+
+/**
+ * @brief Resolves include requests to canonical file paths and caches the result.
+ *
+ * A request is looked up relative to the working directory first and then in
+ * every directory of the `include_path` rule, in order. Absolute requests are
+ * only checked as given. Each distinct request is resolved once per render;
+ * misses are cached as well, so a template that includes the same file many
+ * times costs one path lookup instead of one per include. The cache is
+ * dropped whenever the `include_path` rule changes.
+ */
+class IncludeResolver {
+public:
+    /**
+     * @brief Resolves an include request.
+     * @param request File name as written in the include directive.
+     * @param rules Rules providing the include search directories.
+     * @return Canonical path of the first existing candidate, or `std::nullopt`.
+     */
+    std::optional<std::filesystem::path> resolve(std::string_view request, const Rules& rules);
+
+private:
+    /** Hash that lets `resolve` look up a `std::string_view` without building a `std::string`. */
+    struct RequestHash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view request) const { return std::hash<std::string_view>{}(request); }
+    };
+
+    std::string include_path;                             ///< `include_path` rule the cache was built for.
+    std::vector<std::filesystem::path> directories;       ///< Search directories parsed from `include_path`.
+    std::unordered_map<std::string, std::optional<std::filesystem::path>, RequestHash, std::equal_to<>> cache; ///< Resolved paths and misses by request.
+
+    /** @brief Looks a request up on the file system. */
+    std::optional<std::filesystem::path> lookup(const std::filesystem::path& request) const;
+};
+
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace prebyte {
+
+/**
+ * @brief Content of an included file, shared between all renders that include it.
+ */
+struct IncludedFile {
+    std::uint64_t hash = 0;  /**< FNV-1a hash of `content`. */
+    std::string content;     /**< The file content. */
+};
+
+/**
+ * @brief Process-wide store of included file contents.
+ *
+ * Every file read for an include passes through the store. Files with the same
+ * content, under any path, share a single `IncludedFile`, so the process keeps
+ * one copy of each distinct partial no matter how many renders, batch rows or
+ * `Prebyte` instances include it. The pointer identity of an `IncludedFile`
+ * therefore identifies its content, which `include_once` relies on.
+ *
+ * A path is read again only when its size or modification time changed. The
+ * store is safe to use from several threads.
+ */
+class IncludeStore {
+public:
+    /** @brief Returns the store shared by the whole process. */
+    static IncludeStore& shared();
+
+    /**
+     * @brief Returns the content of a file, reading it only if it is not known or changed.
+     * @param path Canonical path of the file.
+     * @return The shared content.
+     * @throws std::runtime_error if the file cannot be read.
+     */
+    std::shared_ptr<const IncludedFile> load(const std::filesystem::path& path);
+
+    /** @brief Returns the number of bytes held by the distinct contents in the store. */
+    std::size_t retained_bytes();
+
+    /** @brief Forgets all files. Contents still referenced by a render stay valid. */
+    void clear();
+
+private:
+    /** Content known for a path, with the file stamp it was read at. */
+    struct PathEntry {
+        std::uintmax_t size = 0;
+        std::filesystem::file_time_type mtime;
+        std::shared_ptr<const IncludedFile> file;
+    };
+
+    std::mutex mutex;                                                         ///< Guards both maps.
+    std::unordered_map<std::string, PathEntry> paths;                         ///< Known files by path.
+    std::unordered_map<std::uint64_t, std::vector<std::weak_ptr<const IncludedFile>>> contents; ///< Distinct contents by hash.
+
+    /** @brief Returns the stored copy of a content, adding it if it is new. Expects `mutex` to be held. */
+    std::shared_ptr<const IncludedFile> intern(std::string content);
+};
+
+}
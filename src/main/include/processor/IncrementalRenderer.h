@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "datatypes/Context.h"
+#include "processor/ParallelPlan.h"
+#include "processor/Preprocessor.h"
+#include "processor/Template.h"
+
+namespace prebyte {
+
+/**
+ * @brief Renders one input repeatedly and reuses the output of blocks whose inputs did not change.
+ *
+ * The input is compiled once and split like a parallel render (see
+ * `ParallelPlan`): the part up to the last state-changing directive is
+ * rendered every time, and the top-level blocks after it are cached one by one.
+ *
+ * A block depends on every name used in its actions (variables, conditions,
+ * loop arrays and macro arguments) and on the bodies of the macros it calls,
+ * together with the names used in those bodies. When a block is rendered, the
+ * current values of these dependencies are stored with its output. On the next
+ * render the block is only rendered again if one of them changed, so the work
+ * of a re-render follows what changed instead of the size of the input.
+ *
+ * Blocks using built-in variables (`__TIME__`, ...), `$` environment lookups,
+ * `@path` variable values or for loops over files are rendered every time. The
+ * rules and ignores in effect after the sequential part are part of the cache
+ * key: if they differ from the last render, by a directive or through the API,
+ * every block is rendered again. With `allow_env_fallback` nothing is reused.
+ */
+class IncrementalRenderer {
+public:
+    static constexpr std::size_t BLOCK_SIZE = 1024; ///< Input bytes after which a cached block ends at the next top-level boundary.
+
+    /**
+     * @brief Keeps an input for incremental renders; it is compiled on the first render.
+     * @param input Raw input text.
+     */
+    explicit IncrementalRenderer(std::string input);
+
+    /**
+     * @brief Renders the input, reusing unchanged blocks of the previous render.
+     * @param preprocessor Preprocessor owning `context`; it renders the blocks that changed.
+     * @param context The context of `preprocessor`.
+     * @return The complete output.
+     */
+    std::string render(Preprocessor& preprocessor, Context& context);
+
+    /** @brief Returns the number of blocks taken from the cache by the last render. */
+    std::size_t get_reused_blocks() const { return this->reused_blocks; }
+
+    /** @brief Returns the number of blocks rendered by the last render. */
+    std::size_t get_rendered_blocks() const { return this->rendered_blocks; }
+
+private:
+    /** @brief A name read by a block, with its value when the block was rendered. */
+    struct Dependency {
+        std::string name;                               ///< Variable or macro name.
+        std::optional<std::vector<std::string>> value;  ///< Variable value; `nullopt` if unset.
+        std::optional<std::string> macro;               ///< Macro body; `nullopt` if no such macro.
+    };
+
+    /** @brief A cached top-level block. */
+    struct Block {
+        std::set<std::string> names;           ///< Words used in the block's actions.
+        bool cacheable = true;                 ///< False if the output may change without a dependency changing.
+        bool valid = false;                    ///< Whether `output` may be reused.
+        std::string output;                    ///< Output of the last render.
+        std::vector<Dependency> dependencies;  ///< Values `output` was rendered with.
+    };
+
+    std::string input;                   ///< The raw input.
+    std::vector<Template> parts;         ///< Sequential part followed by one template per block.
+    ParallelPlan plan;                   ///< Split points and loop bindings of `parts`.
+    std::vector<Block> blocks;           ///< Dependencies and cached output per block.
+    bool compiled = false;               ///< Whether `parts` was built.
+    std::uint64_t settings_revision = 0; ///< `Context::settings_revision` the cache was built for.
+    Rules rules;                         ///< Rules the cached blocks were rendered with.
+    IgnoreList ignore;                   ///< Ignores the cached blocks were rendered with.
+    std::size_t reused_blocks = 0;       ///< Blocks reused by the last render.
+    std::size_t rendered_blocks = 0;     ///< Blocks rendered by the last render.
+
+    /** @brief Compiles and splits the input with the current delimiters and drops all cached output. */
+    void compile(Context& context);
+
+    /**
+     * @brief Collects the current values of everything a block reads.
+     *
+     * Besides the block's own names, this covers the bodies of the macros it
+     * calls and the names used in them, transitively.
+     */
+    std::vector<Dependency> capture(const Block& block, const Context& context) const;
+
+    /** @brief Checks whether the dependencies of a block still have the stored values. */
+    bool is_current(const Block& block, const Context& context) const;
+};
+
+}
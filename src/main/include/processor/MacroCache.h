@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+namespace prebyte {
+
+/**
+ * @brief Bounded cache of pure macro call results for a single render.
+ *
+ * Entries are keyed by the macro name and its argument values (see `key`).
+ * When the cache is full, the least recently used entry is dropped. Lookups
+ * are counted, so the hit rate can be shown with `benchmark`.
+ */
+class MacroCache {
+public:
+    /**
+     * @brief Builds the key of a macro call.
+     * @param macro_name Name of the called macro.
+     * @param args Argument values of the call.
+     * @return Name and arguments, each terminated by a `'\0'`.
+     */
+    template <typename Args>
+    static std::string key(std::string_view macro_name, const Args& args) {
+        std::string result(macro_name);
+        result += '\0';
+        for (const auto& arg : args) {
+            result.append(arg.data(), arg.size());
+            result += '\0';
+        }
+        return result;
+    }
+
+    /**
+     * @brief Sets the maximum number of entries, dropping the oldest ones if needed.
+     * @param capacity Maximum number of entries (0 = keep nothing).
+     */
+    void set_capacity(std::size_t capacity);
+
+    /**
+     * @brief Looks up the output of a call and counts a hit or a miss.
+     * @param key Key built by `key`.
+     * @return The cached output, or `nullptr`. Valid until the cache is changed.
+     */
+    const std::string* find(const std::string& key);
+
+    /**
+     * @brief Stores the output of a call as the most recently used entry.
+     * @param key Key built by `key`.
+     * @param output Rendered output of the call.
+     */
+    void insert(const std::string& key, std::string output);
+
+    /** @brief Drops all entries. The hit and miss counters are kept. */
+    void clear();
+
+    /** @brief Returns the number of lookups that found an entry. */
+    std::size_t get_hits() const { return this->hits; }
+
+    /** @brief Returns the number of lookups that found no entry. */
+    std::size_t get_misses() const { return this->misses; }
+
+    /** @brief Returns the number of entries. */
+    std::size_t size() const { return this->entries.size(); }
+
+private:
+    using Entry = std::pair<std::string, std::string>;
+
+    std::list<Entry> entries;                                               ///< Key and output, most recently used first.
+    std::unordered_map<std::string, std::list<Entry>::iterator> index;      ///< Entry per key.
+    std::size_t capacity = 0;                                               ///< Maximum number of entries.
+    std::size_t hits = 0;                                                   ///< Lookups that found an entry.
+    std::size_t misses = 0;                                                 ///< Lookups that found no entry.
+};
+
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "processor/Template.h"
+
+namespace prebyte {
+
+/**
+ * @brief Decides whether macro bodies are pure, i.e. leave the render state unchanged.
+ *
+ * A body is classified by its segments: text is always pure, variables and
+ * conditions depending on the `Options`, and every other directive (`set`,
+ * `for`, `include`, rules, profiles, ...) makes it impure. A call of another
+ * macro is pure if that macro is pure with the same options. Results are
+ * remembered per macro until `clear()`; recursive calls count as impure.
+ *
+ * The `Preprocessor` uses it to memoize macro calls, `ParallelPlan` to check
+ * the macros called by parallel chunks and the `Specializer` to fold across
+ * macro calls.
+ */
+class MacroClassifier {
+public:
+    /** @brief What a pure body may contain. */
+    struct Options {
+        /**
+         * Whether the output may only depend on the macro arguments. Variables
+         * other than `ARGS[...]` and conditions are impure then, and nested
+         * calls may only pass string literals or `ARGS[...]`.
+         */
+        bool arguments_only = false;
+        std::vector<std::string> forbidden_names{};   ///< Names that no action of a pure body may contain.
+        const std::unordered_set<std::string>* declared_pure = nullptr; ///< Macros taken as pure without looking at their body.
+    };
+
+    /** @brief Returns the compiled body of a macro, or `nullptr` if it is not defined. */
+    using BodyLookup = std::function<std::shared_ptr<const Template>(const std::string&)>;
+
+    /**
+     * @brief Creates a classifier.
+     * @param options What a pure body may contain.
+     * @param lookup Provides the macro bodies; undefined macros are impure.
+     */
+    MacroClassifier(Options options, BodyLookup lookup);
+
+    /**
+     * @brief Checks whether calling a macro is pure.
+     * @param macro_name Name of the macro.
+     */
+    bool is_pure(const std::string& macro_name);
+
+    /**
+     * @brief Checks whether a range of segments is pure.
+     * @param segments Segments of a macro body or definition.
+     * @param first Index of the first segment.
+     * @param last Index behind the last segment.
+     */
+    bool is_pure(const std::vector<Segment>& segments, std::size_t first, std::size_t last);
+
+    /** @brief Forgets all results, e.g. after macros or delimiters changed. */
+    void clear();
+
+private:
+    Options options;                              ///< What a pure body may contain.
+    BodyLookup lookup;                            ///< Provides the macro bodies.
+    std::unordered_map<std::string, bool> known;  ///< Results by macro name.
+
+    /** @brief Checks that the arguments of a nested call are string literals or `ARGS[...]`. */
+    static bool literal_arguments(std::string_view arguments);
+};
+
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace prebyte {
+
+/**
+ * @brief Produces outputs on several threads and consumes them in index order.
+ *
+ * `work(index, worker)` is called for every index in `[0, count)` on up to
+ * `threads` threads; `worker` is the number of the calling thread in
+ * `[0, threads)`, so every thread can keep state of its own. `consume(index, output)`
+ * is called on the calling thread, in index order, as soon as the output of an
+ * index and of all indices before it is ready. With a single thread, both run
+ * one after another on the calling thread.
+ *
+ * If `work` or `consume` throws, no new indices are started and the first
+ * exception is rethrown once all threads have stopped.
+ *
+ * @param count Number of indices.
+ * @param threads Number of threads to use (at least 1).
+ * @param work Callable `std::string(std::size_t, std::size_t)` producing the output of an index on a worker.
+ * @param consume Callable `void(std::size_t, std::string&)` receiving the outputs in order.
+ */
+template <typename Work, typename Consume>
+void run_ordered(std::size_t count, std::size_t threads, const Work& work, const Consume& consume) {
+    if (threads <= 1) {
+        for (std::size_t i = 0; i < count; ++i) {
+            std::string output = work(i, 0);
+            consume(i, output);
+        }
+        return;
+    }
+
+    std::vector<std::optional<std::string>> results(count);
+    std::atomic<std::size_t> next = 0;
+    std::atomic<bool> failed = false;
+    std::exception_ptr error;
+    std::mutex mutex;
+    std::condition_variable done;
+
+    auto worker = [&](std::size_t id) {
+        std::size_t index;
+        while (!failed && (index = next++) < count) {
+            try {
+                std::string output = work(index, id);
+                std::lock_guard<std::mutex> lock(mutex);
+                results[index] = std::move(output);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) error = std::current_exception();
+                failed = true;
+            }
+            done.notify_one();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i) {
+        workers.emplace_back(worker, i);
+    }
+
+    try {
+        for (std::size_t i = 0; i < count; ++i) {
+            std::string output;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                done.wait(lock, [&]() { return results[i].has_value() || failed; });
+                if (!results[i]) break;
+                output = std::move(*results[i]);
+                results[i].reset();
+            }
+            consume(i, output);
+        }
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!error) error = std::current_exception();
+        failed = true;
+    }
+
+    for (std::thread& thread : workers) {
+        thread.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "processor/Template.h"
+
+namespace prebyte {
+
+/**
+ * @brief Split of a compiled template into a sequential part and chunks that can be rendered in parallel.
+ *
+ * `make()` scans the classified directives of a template once. Chunks only
+ * start at top-level boundaries, outside of any `if`, `for` or `define` block.
+ * Everything up to the top-level block holding the last state-changing
+ * directive (`set`, `unset`, `define`, profiles, ignores and includes) is left
+ * to the sequential part, so the chunks after it all read the same context.
+ *
+ * A for loop leaves its variable set to the last value. Top-level loops over an
+ * array are recorded in `loop_bindings`, so later chunks can set that value up
+ * front. Any other loop whose variable is mentioned after the loop ends counts
+ * as state-changing, including mentions in the bodies of called macros.
+ */
+class ParallelPlan {
+public:
+    /** @brief Loop variable left behind by a top-level for loop over an array. */
+    struct LoopBinding {
+        std::size_t chunk;     ///< Index of the chunk holding the loop.
+        std::string variable;  ///< Loop variable.
+        std::string array;     ///< Iterated array variable.
+    };
+
+    /**
+     * @brief First segment of every chunk, ascending.
+     *
+     * The first entry is the end of the sequential part (0 if there is none).
+     * Chunk `i` covers the segments from `chunk_starts[i]` up to the next start
+     * or the end of the template.
+     */
+    std::vector<std::size_t> chunk_starts;
+    std::vector<LoopBinding> loop_bindings; ///< Top-level array loops of the chunks, in input order.
+    std::vector<std::string> macro_calls;   ///< Macros executed by the chunks; see `macros_are_pure()`.
+    std::vector<std::string> leaked_variables; ///< Variables of loops not covered by `loop_bindings`, sorted.
+
+    /**
+     * @brief Scans a template for split points.
+     * @param compiled The compiled input.
+     * @param chunk_bytes Input bytes after which a chunk is ended at the next top-level boundary.
+     * @return The plan; `parallel()` is `false` if fewer than two chunks were found.
+     */
+    static ParallelPlan make(const Template& compiled, std::size_t chunk_bytes);
+
+    /** @brief Checks whether the template was split into at least two chunks. */
+    bool parallel() const { return this->chunk_starts.size() > 1; }
+
+    /**
+     * @brief Checks that the macros called by the chunks do not change state.
+     *
+     * A macro body may only contain text, variables, conditionals and calls of
+     * other such macros (see `MacroClassifier`), and must not mention one of the `leaked_variables`: a
+     * chunk would not see the value their loop left behind. Called once the
+     * sequential part has been rendered, since it may define the macros.
+     *
+     * @param macros Macro bodies by name.
+     * @param prefix Current variable prefix.
+     * @param suffix Current variable suffix.
+     * @return `true` if all called macros are known and free of state changes.
+     */
+    bool macros_are_pure(const std::map<std::string, std::string>& macros, const std::string& prefix, const std::string& suffix) const;
+};
+
+}
@@ -1,20 +1,39 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <iostream>
 #include <filesystem>
 #include <fstream>
 #include <sstream>
 #include <stack>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "processor/Processor.h"
 #include "processor/ProcessingVariables.h"
 #include "processor/ProcessingFlow.h"
+#include "processor/IncludeStore.h"
+#include "processor/MacroCache.h"
+#include "processor/MacroClassifier.h"
+#include "processor/ParallelPlan.h"
+#include "processor/Template.h"
 #include "datatypes/Context.h"
+#include "datatypes/Environment.h"
+#include "datatypes/MemoryStats.h"
+#include "datatypes/OutputFile.h"
 #include "processor/FlowState.h"
 #include "parser/YamlParser.h"
 #include "datatypes/Profile.h"
 #include "parser/StringParser.h"
+#include "parser/CsvReader.h"
+#include "parser/JsonParser.h"
+#include "parser/XmlParser.h"
 #include "datatypes/Rules.h"
 
 namespace prebyte {
@@ -33,20 +52,60 @@ namespace prebyte {
  * - Benchmarking and output construction
  *
  * It inherits from `Processor` and implements the `process()` method as its primary entry point.
+ *
+ * Transient render state (the frame stack, macro arguments, loop values and
+ * parsed macro call arguments) is allocated from a per-render arena that is
+ * released in one piece when the `Preprocessor` is destroyed. Output buffers
+ * stay ordinary strings: they grow to the size of the result and are handed
+ * to the caller, which a monotonic arena could not reclaim on reallocation.
  */
 class Preprocessor : public Processor {
 private:
+    /** @brief What started a frame of the execution stack. */
+    enum class FrameKind {
+        ROOT,     /**< The template passed to `process_all`. */
+        INCLUDE,  /**< An included file. */
+        MACRO     /**< A macro call. */
+    };
+
+    /**
+     * @brief A template being rendered by `process_all`.
+     *
+     * Includes and macro calls push a frame instead of recursing. For loops
+     * still render their body through a nested `process_all`, so an include or
+     * macro call inside a loop body does use native stack space; that nesting
+     * is bounded by the `max_include_depth` and `max_macro_depth` rules.
+     */
+    struct Frame {
+        FrameKind kind = FrameKind::ROOT;        ///< What started the frame.
+        std::shared_ptr<const Template> owned{}; ///< Keeps `current` alive unless it is the caller's template.
+        const Template* current = nullptr;       ///< Template being rendered.
+        std::size_t index = 0;                   ///< Next segment to render.
+        std::size_t writes_to = 0;               ///< Frame whose output receives this frame's output; 0 is the render's output.
+        std::string output{};                    ///< Output so far, if the frame writes to itself (a cached macro call).
+        std::string include_path{};              ///< Included file of an INCLUDE frame.
+        std::string cache_key{};                 ///< Key of a pure MACRO frame whose output is cached; empty otherwise.
+    };
+
+    CountingResource counting;                     ///< Reports arena blocks to the active `MemoryScope`.
+    std::pmr::monotonic_buffer_resource arena{&counting};  ///< Per-render arena; released when the render ends.
+    std::pmr::unsynchronized_pool_resource pool{&arena};   ///< Reuses freed arena memory, so loops do not grow the arena.
+
     std::string input;                             ///< The input text or content to be processed.
     std::string output;                            ///< The final output after preprocessing.
     ProcessingVariables process_variables;         ///< Internal structure managing runtime variable state.
     ProcessingFlow process_flow;                   ///< Internal structure managing flow control state.
     std::stack<FlowState> flow_states;             ///< Stack to track nested flow states (e.g. IF, FOR).
-    std::vector<std::filesystem::path> processed_includes;  ///< Tracks included files to prevent duplicates.
+    std::vector<std::filesystem::path> processed_includes;  ///< Chain of files currently being included, outermost first.
+    std::unordered_set<std::string> active_includes;        ///< Paths in `processed_includes`, for cycle detection.
+    std::optional<Frame> pending_frame;                     ///< Frame requested by the last action, pushed by `process_all`.
     
     bool ignore_next = false;                      ///< Indicates whether the next line should be ignored.
     ushort current_depth = 0;                      ///< Current depth of nested includes or macros.
-    ushort ignore_all = 0;                         ///< Counter used to ignore entire blocks (e.g. during IF false).
+    std::vector<bool> branch_taken;                ///< Per open conditional, innermost last: whether one of its branches was taken.
     ushort ignore_depth = 0;                       ///< Tracks how deeply we are in ignored structures.
+    std::string* sink_output = nullptr;            ///< Output of the top-level render, the only buffer flushed into the output sink.
+    std::string* action_output = nullptr;          ///< Output the current action renders into; loops append their iterations here.
     
     bool pipe = false;                             ///< Whether output should be piped into another processor.
     
@@ -55,34 +114,207 @@ private:
     std::string macro_name;                        ///< Current macro being executed.
     std::string for_variable;                      ///< Variable used in current FOR loop.
     int for_stack = 0;                             ///< Nesting depth of FOR loops.
-    std::stack<std::vector<std::string>> macro_args; ///< Stack of macro arguments per invocation.
+    std::pmr::vector<std::pmr::vector<std::pmr::string>> macro_args{&pool}; ///< Stack of macro arguments per invocation, innermost last.
+    std::unordered_map<std::string, std::shared_ptr<const Template>> compiled_macros; ///< Macro bodies compiled on first execution.
+    MacroClassifier macro_purity;                  ///< Whether a macro only depends on its arguments: it is defined as `pure`, or only uses `ARGS`.
+    MacroCache macro_cache;                        ///< Outputs of pure macro calls, see the `macro_cache_size` rule.
+    bool macro_pure = false;                       ///< Whether the macro being defined is declared `pure`.
+    std::unordered_map<std::string, std::shared_ptr<const IncludedFile>> included_files; ///< Include contents by path, loaded once per render.
+    std::unordered_map<const IncludedFile*, std::shared_ptr<const Template>> compiled_includes; ///< Include contents compiled on first use.
+    std::unordered_set<const IncludedFile*> included_contents; ///< Distinct contents included so far, checked by `include_once`.
+    std::size_t flushed_bytes = 0;                 ///< Output bytes already handed to the output sink.
+    std::int64_t loop_iterations = 0;              ///< For loop iterations rendered so far, checked against `max_loop_iterations`.
+    std::atomic<std::int64_t>* shared_loop_iterations = nullptr; ///< Iteration counter of the whole render while rendering a parallel chunk.
+    std::uint32_t budget_checks = 0;               ///< Calls of `check_budget`; the clock is only read on every 64th.
+    std::chrono::steady_clock::time_point render_start = std::chrono::steady_clock::now(); ///< Start of the render, for `render_timeout_ms`.
+    std::optional<Environment> environment;        ///< Environment snapshot, taken on the first environment lookup of this render.
+    std::optional<std::map<std::string, std::optional<std::vector<std::string>>>> bound_variables; ///< Previous values of the variables set during a render with bindings.
+    bool context_changed = false;                  ///< Whether a directive changed variables, rules, ignores, profiles or macros of the context.
 
-    /** @brief Retrieves the raw input to process. */
-    std::string get_input() const;
+    static constexpr std::size_t SINK_CHUNK_SIZE = 64 * 1024; ///< Top-level output size that triggers a flush into the output sink.
+    static constexpr std::size_t PARALLEL_CHUNK_SIZE = 256 * 1024; ///< Smallest input size of a chunk rendered in parallel.
 
     /** @brief Builds the final output string. */
-    void make_output() const;
+    void make_output();
+
+    /**
+     * @brief Writes the output into a file through `OutputFile`.
+     *
+     * The file is replaced atomically; with the `skip_unchanged_output` rule an
+     * identical file is not touched.
+     *
+     * @param output_path Target file.
+     */
+    void write_output_file(const std::filesystem::path& output_path);
 
     /**
      * @brief Main preprocessing loop that handles macro expansion, conditionals, includes, etc.
      * @param input The raw input string to process.
      * @return Fully processed output.
      */
-    std::string process_all(std::string input);
+    std::string process_all(const std::string& input);
+
+    /**
+     * @brief Renders an already compiled template.
+     *
+     * Runs an explicit stack of frames: an include or macro call pushes a frame
+     * that writes straight into the output of its caller. Only a cached macro
+     * call collects its output first and appends it once it is done. A for loop
+     * calls this again for every iteration (see `Frame`).
+     *
+     * @param compiled The compiled input.
+     * @return Fully processed output.
+     */
+    std::string process_all(const Template& compiled);
+
+    /**
+     * @brief Renders an already compiled template into an existing output.
+     *
+     * Loops render every iteration through this, so the iterations of a
+     * top-level loop are flushed into the output sink as they are produced.
+     *
+     * @param compiled The compiled input.
+     * @param output Output to append to.
+     */
+    void process_all(const Template& compiled, std::string& output);
+
+    /**
+     * @brief Renders the input in chunks on several threads (see the `parallel_threads` rule).
+     *
+     * The input is split with `ParallelPlan`. Its sequential part is rendered
+     * first; every chunk after it is then rendered by a `Preprocessor` of its own
+     * on a copy of the context, and the outputs are appended in input order.
+     * Falls back to a sequential render if no split is possible, the sequential
+     * part changed the delimiters, or a called macro changes state.
+     *
+     * @param input The raw input string to process.
+     * @param threads Number of threads to use.
+     * @return Fully processed output.
+     */
+    std::string process_parallel(const std::string& input, std::size_t threads);
+
+    /** @brief Returns the number of threads set by the `parallel_threads` rule (0 = all cores). */
+    std::size_t get_parallel_threads() const;
+
+    /**
+     * @brief Requests a new frame for an include or macro call.
+     *
+     * Ends the program if the frame would exceed the `max_include_depth` or
+     * `max_macro_depth` rule.
+     *
+     * @param frame The frame; `process_all` pushes it after the current action.
+     */
+    void enter_frame(Frame frame);
+
+    /**
+     * @brief Aborts the render if it was cancelled or ran out of time.
+     *
+     * Called for every action and loop iteration. The cancellation flag is read
+     * every time, the clock only on every 64th call.
+     */
+    void check_budget();
+
+    /** @brief Counts a for loop iteration against `max_loop_iterations` and checks the budget. */
+    void count_loop_iteration();
+
+    /**
+     * @brief Undoes the bookkeeping of a finished include or macro frame.
+     * @param frame The finished frame.
+     */
+    void leave_frame(const Frame& frame);
+
+    /**
+     * @brief Compiles input text using the current variable prefix and suffix.
+     * @param input The raw input string.
+     * @return The compiled template.
+     */
+    Template compile(const std::string& input);
+
+    /**
+     * @brief Renders a for loop body once per row of a CSV file.
+     *
+     * The file is streamed record by record, so it is never held in memory as a whole.
+     * Each column is bound as `<variable>.<column>`; `<variable>` holds the fields of the row.
+     *
+     * @param variable Loop variable name.
+     * @param source Path to the CSV file; the first record holds the column names.
+     * @param body The compiled loop body.
+     * @param output Receives the output of all iterations.
+     */
+    void process_csv_loop(const std::string& variable, const std::string& source, const Template& body, std::string& output);
+
+    /**
+     * @brief Renders a for loop body once per element of a JSON array, JSON Lines file or XML root.
+     *
+     * Elements are converted one at a time, so the `Data` tree of the whole file is never built.
+     * Object members are bound as `<variable>.<key>` (nested objects as `<variable>.<key>.<key>`);
+     * XML attributes are bound as `<variable>.@<name>`.
+     *
+     * @param variable Loop variable name.
+     * @param source Path to the `.json`, `.jsonl`, `.ndjson` or `.xml` file.
+     * @param body The compiled loop body.
+     * @param output Receives the output of all iterations.
+     */
+    void process_element_loop(const std::string& variable, const std::string& source, const Template& body, std::string& output);
+
+    /**
+     * @brief Binds a parsed value to loop variables.
+     * @param name Variable name for the value.
+     * @param element The value; maps are bound member by member.
+     * @param bound Receives the names of all variables that were set.
+     */
+    void bind_element(const std::string& name, const Data& element, std::vector<std::string>& bound);
+
+    /**
+     * @brief Returns a variable that is about to be set by a loop.
+     *
+     * During a render with bindings, the previous value is remembered so the
+     * variable can be restored afterwards.
+     *
+     * @param name Variable name.
+     * @return The variable, created empty if it did not exist.
+     */
+    std::vector<std::string>& bind_variable(const std::string& name);
+
+    /**
+     * @brief Returns the compiled body of a macro, compiling it on first use.
+     * @param macro_name Name of the macro.
+     * @return Shared pointer to the compiled macro body.
+     */
+    std::shared_ptr<const Template> get_compiled_macro(const std::string& macro_name);
+
+    /**
+     * @brief Returns the content of an include file from the shared `IncludeStore`.
+     * @param include_path Resolved path of the file.
+     * @return The shared content; ends the program if the file cannot be read.
+     */
+    std::shared_ptr<const IncludedFile> get_included_file(const std::filesystem::path& include_path);
+
+    /**
+     * @brief Returns an include content compiled with the current delimiters, compiling it on first use.
+     * @param included The include content.
+     * @return Shared pointer to the compiled content.
+     */
+    std::shared_ptr<const Template> get_compiled_include(const std::shared_ptr<const IncludedFile>& included);
+
+    /** @brief Returns the environment snapshot of this render, taking it on first use. */
+    const Environment& get_environment();
 
     /**
      * @brief Executes a single preprocessing action or directive.
      * @param action The action to perform (e.g. macro, control structure).
+     * @param directive The classification of `action` made when the template was compiled.
      * @return Output generated from the action.
      */
-    std::string do_action(const std::string& action);
+    std::string do_action(const std::string& action, const Directive& directive);
 
     /**
      * @brief Handles flow-control actions (IF, FOR, ELSE, etc.).
      * @param action The flow control action string.
+     * @param directive The classification of `action`.
      * @return Result of the action (may be empty).
      */
-    std::string process_code_flow(const std::string& action);
+    std::string process_code_flow(const std::string& action, const Directive& directive);
 
     /**
      * @brief Adds a string to the output, applying preprocessing logic if needed.
@@ -91,9 +323,23 @@ private:
      */
     void add_string(std::string& output, const std::string& str);
 
-    /** @brief Prints benchmark information such as execution time. */
+    /**
+     * @brief Hands buffered top-level output to the context's output sink.
+     *
+     * Includes, macro calls and loop iterations write into the top-level output
+     * directly, so they are streamed as well. Only the output of a cached macro
+     * call is collected before it is appended.
+     *
+     * @param output Buffered top-level output; cleared after flushing.
+     */
+    void flush_to_sink(std::string& output);
+
+    /** @brief Prints benchmark information such as execution time and memory use. */
     void make_benchmark() const;
 
+    /** @brief Returns the bytes held by the render's caches and the shared include store. */
+    std::size_t retained_bytes();
+
     /** @brief Extracts rule definitions from a `Data` object. */
     std::map<std::string, std::string> get_rules(const Data& rules);
 
@@ -104,11 +350,11 @@ private:
     std::map<std::string, std::vector<std::string>> get_variables(const Data& variables);
 
     /**
-     * @brief Retrieves the list of values for a variable by name.
-     * @param variable Variable name.
-     * @return List of values assigned to the variable.
+     * @brief Resolves the space separated arguments of a macro call.
+     * @param variable Argument list: quoted strings, variables, `name[index]` or `name#`.
+     * @return The argument values, allocated from the render's arena.
      */
-    std::vector<std::string> get_variable_values(std::string variable);
+    std::pmr::vector<std::pmr::string> get_variable_values(std::string_view variable);
 
     /**
      * @brief Converts a time duration to a readable string format.
@@ -117,6 +363,13 @@ private:
      */
     std::string get_time_conversion(const std::chrono::nanoseconds& duration) const;
 
+    /**
+     * @brief Converts a byte count to a readable string format.
+     * @param bytes Number of bytes.
+     * @return Human-readable size string.
+     */
+    std::string get_memory_conversion(std::size_t bytes) const;
+
 public:
     /**
      * @brief Constructs a `Preprocessor` from a given context.
@@ -132,6 +385,37 @@ public:
      * and builds the final output.
      */
     void process() override;
+
+    /**
+     * @brief Renders a compiled template against the current context.
+     *
+     * Unlike `process()`, no input is read and no output is written; the result
+     * is returned to the caller. This is used to render one compiled template
+     * against many variable sets.
+     *
+     * @param compiled The compiled template.
+     * @return The processed output.
+     */
+    std::string render(const Template& compiled);
+
+    /**
+     * @brief Renders a compiled template with some variables bound for this render only.
+     *
+     * The bound variables and the variables set by for loops are restored
+     * afterwards, so the same `Preprocessor` can render the next row against
+     * its context. Budgets and `include_once` start over with every call.
+     *
+     * @param compiled The compiled template.
+     * @param variables Variables to bind.
+     * @return The processed output.
+     */
+    std::string render(const Template& compiled, const std::map<std::string, std::vector<std::string>>& variables);
+
+    /**
+     * @brief Checks whether a render changed the context in a way `render` does not restore.
+     * @return `true` if a directive set variables, rules, ignores or profiles, or defined a macro or profile.
+     */
+    bool changed_context() const;
 };
 
 }
@@ -7,10 +7,10 @@
 #include <sstream>
 #include <ctime>
 #include <chrono>
-#include <unordered_map>
-#include <random>
+#include <array>
+#include <optional>
+#include <string_view>
 #include <format>
-#include <functional>
 
 #include "datatypes/Context.h"
 
@@ -50,6 +50,9 @@ enum class VariableAction {
     FILE_CREATED    /**< File creation timestamp (if available). */
 };
 
+/** @brief Number of entries in `VariableAction`. */
+inline constexpr std::size_t VARIABLE_ACTION_COUNT = static_cast<std::size_t>(VariableAction::FILE_CREATED) + 1;
+
 /**
  * @brief Provides dynamic resolution for built-in system or context variables.
  *
@@ -59,15 +62,30 @@ enum class VariableAction {
  *
  * This class is constructed with a pointer to the current `Context`, and uses standard
  * library functions and OS interfaces to provide accurate and timely values.
+ *
+ * All values are fixed for the lifetime of an instance (one render): each one is computed
+ * the first time it is used and served from a cache afterwards, so loops that stamp
+ * `__DATETIME__` into every row format it only once.
  */
 class ProcessingVariables {
 private:
-    std::unordered_map<std::string, std::function<std::string()>> functionality;  ///< Mapping of variable keys to resolver functions.
     std::chrono::time_point<std::chrono::system_clock> current_time;              ///< Captured time for consistent timestamp variables.
     Context* context;                                                             ///< Pointer to the current execution context.
+    mutable std::optional<std::tm> local_time;                                    ///< `current_time` broken down in local time, once needed.
+    mutable std::array<std::optional<std::string>, VARIABLE_ACTION_COUNT> cache;  ///< Values that were already resolved.
+
+    /**
+     * @brief Maps a variable key such as `__DATE__` to its action.
+     * @param key The variable key including the underscores.
+     * @return The action, or `std::nullopt` for unknown keys.
+     */
+    static std::optional<VariableAction> find_action(std::string_view key);
+
+    /** @brief Computes the value of a built-in variable. */
+    std::string compute(VariableAction action) const;
 
     /** @brief Gets the current local time as a `std::tm` structure. */
-    std::tm getLocalTime() const;
+    const std::tm& getLocalTime() const;
 
     /** @brief Returns the current date (YYYY-MM-DD). */
     std::string _DATE() const;
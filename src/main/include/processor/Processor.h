@@ -1,6 +1,8 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <iostream>
 #include <filesystem>
 #include <fstream>
 #include <sstream>
@@ -26,6 +28,16 @@ class Processor {
 protected:
     std::unique_ptr<Context> context;  ///< The current execution context.
 
+    /**
+     * @brief Reads the raw input for the current action type.
+     *
+     * Depending on the action type the input comes from the input file,
+     * standard input or the string handed over by the API.
+     *
+     * @return The input text (empty if no input was provided).
+     */
+    std::string get_input() const;
+
     /**
      * @brief Retrieves the string value of a variable from the context.
      * @param variable_name Name of the variable to retrieve.
@@ -41,6 +53,13 @@ protected:
      */
     std::string get_variable_name(const std::string& action) const;
 
+    /**
+     * @brief Extracts the variable name from an action without copying it.
+     * @param action The action string (e.g., `name` or `name[2]`).
+     * @return A view of the name within `action`, or an empty view if the action is no variable reference.
+     */
+    std::string_view get_variable_name_view(std::string_view action) const;
+
     /**
      * @brief Extracts the variable value from an action string.
      * @param action The full action string.
@@ -68,6 +87,17 @@ public:
      * It defines the behavior for how input is handled, transformed, or responded to.
      */
     virtual void process() = 0;
+
+    /**
+     * @brief Hands the execution context back to the caller.
+     *
+     * Processors take ownership of the context for the duration of a run. API callers
+     * that want to keep using their variables, rules and profiles afterwards retrieve
+     * it again through this method. The processor must not be used afterwards.
+     *
+     * @return The context this processor was working on.
+     */
+    std::unique_ptr<Context> release_context();
 };
 
 }
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "processor/ConditionEvaluator.h"
+#include "processor/MacroClassifier.h"
+#include "processor/Processor.h"
+#include "processor/Template.h"
+#include "datatypes/Context.h"
+
+namespace prebyte {
+
+/**
+ * @brief Partially evaluates an input against variables that are constant for a deployment.
+ *
+ * The `Specializer` produces a residual template: references to constant variables
+ * are replaced by their values, `if`/`elif` branches whose conditions only depend
+ * on constants are resolved, and `for` loops over constant arrays are unrolled.
+ * Everything else is kept as written, so rendering the residual with the same
+ * settings gives the same output as rendering the input.
+ *
+ * Specialization is conservative. A `set var` or `unset var` makes its variable
+ * dynamic from there on. Directives whose effect cannot be followed (rules,
+ * profiles, ignores, includes, and macros or loops that change state) stop
+ * folding for the rest of the input; the remaining directives are kept as written.
+ */
+class Specializer : public Processor {
+public:
+    /**
+     * @brief Constructs a `Specializer` from a given context.
+     * @param context Execution context whose variables provide the constant values.
+     */
+    Specializer(std::unique_ptr<Context> context);
+
+    /**
+     * @brief Specializes the CLI input against the context's constants.
+     *
+     * Writes the residual template to standard output or the output file.
+     */
+    void process() override;
+
+    /**
+     * @brief Specializes an input.
+     * @param input Raw input text.
+     * @param constants Names of the variables declared constant; empty to use all variables of the context.
+     * @return The residual template.
+     */
+    std::string specialize(const std::string& input, const std::vector<std::string>& constants);
+
+private:
+    /** @brief State of an `if` chain being specialized. */
+    struct Chain {
+        bool live = true;       ///< Whether the chain is reached at all (not inside a removed branch).
+        bool open = false;      ///< Whether an `if` for this chain was written to the residual.
+        bool decided = false;   ///< Whether a branch is known to be taken; later branches are removed.
+        bool emitting = false;  ///< Whether the current branch is written to the residual.
+    };
+
+    const Template* current = nullptr;              ///< Template being specialized.
+    std::unordered_set<std::string> constants;      ///< Variables whose values may be folded.
+    MacroClassifier safe_macros;                    ///< Whether a macro call leaves the state unchanged.
+    ConditionEvaluator conditions;                  ///< Partially evaluates conditions against the constants.
+    std::unordered_map<std::string, std::string> defined_macros; ///< Macro bodies defined by the input, as written.
+    std::vector<std::string> residual_actions;      ///< Actions written to the residual, to verify it compiles the same way.
+    bool frozen = false;                            ///< Set once the state can no longer be followed; stops folding.
+    std::size_t folded_actions = 0;                 ///< Variable references replaced by their values.
+    std::size_t pruned_branches = 0;                ///< Conditions resolved statically.
+    std::size_t unrolled_loops = 0;                 ///< Loops replaced by their iterations.
+
+    /**
+     * @brief Specializes a range of segments of `current`.
+     * @param first Index of the first segment.
+     * @param last Index behind the last segment.
+     * @param out Receives the residual.
+     */
+    void specialize_range(std::size_t first, std::size_t last, std::string& out);
+
+    /**
+     * @brief Specializes a `for` loop.
+     * @param index Index of the `for` segment.
+     * @param end Index of the matching `endfor` segment.
+     * @param out Receives the residual.
+     */
+    void specialize_loop(std::size_t index, std::size_t end, std::string& out);
+
+    /**
+     * @brief Replaces a variable reference by its value if it is constant.
+     * @param action The action text.
+     * @return The value, or nothing if the action has to stay.
+     */
+    std::optional<std::string> fold_action(const std::string& action) const;
+
+    /**
+     * @brief Resolves a variable of a condition; only constants are known.
+     *
+     * A known value is written to the residual as a string literal, unless it
+     * contains characters that would change how the condition is split.
+     */
+    ConditionEvaluator::Operand resolve_operand(const std::string& name) const;
+
+    /**
+     * @brief Checks whether an action after the given segment mentions a name.
+     * @param index Index of the segment to start behind.
+     * @param name The name to look for.
+     */
+    bool referenced_after(std::size_t index, const std::string& name) const;
+
+    /** @brief Writes a directive built by the specializer to the residual. */
+    void emit_action(std::string& out, const std::string& action);
+
+    /** @brief Writes segments unchanged to the residual. */
+    void emit_source(std::string& out, std::size_t first, std::size_t last);
+
+    /**
+     * @brief Returns the index of the segment closing a block.
+     * @param index Index of the segment opening the block.
+     * @param last Index behind the last segment to search.
+     * @param open Directive that opens a nested block of the same kind.
+     * @param close Directive that closes the block.
+     * @return The index, or `last` if the block is not closed before it.
+     */
+    std::size_t find_block_end(std::size_t index, std::size_t last, FlowType open, FlowType close) const;
+};
+
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#include "processor/Directive.h"
+
+namespace prebyte {
+
+/**
+ * @brief Kind of a compiled template segment.
+ */
+enum class SegmentType {
+    TEXT,   /**< Literal text that is copied to the output. */
+    ACTION  /**< Content between prefix and suffix (variable, built-in or directive). */
+};
+
+/**
+ * @brief A single piece of a compiled template.
+ */
+struct Segment {
+    SegmentType type;       /**< Whether the segment is literal text or an action. */
+    std::string content;    /**< The literal text, or the action without prefix and suffix. */
+    bool linewise = false;  /**< True for `%%#...` actions that run until the end of the line. */
+    Directive directive{};  /**< Directive keyword of an action, classified once at compile time. */
+    bool unterminated = false; /**< True for a trailing action without suffix; `content` holds the raw rest of the input. */
+};
+
+/**
+ * @brief Input text split into literal text and action segments.
+ *
+ * A `Template` is the result of scanning an input once for the variable prefix and
+ * suffix. The `Preprocessor` renders the segments directly, so text that is rendered
+ * more than once (loop bodies, macros, or one template against many rows) only has
+ * to be scanned a single time.
+ *
+ * A compiled template remembers the prefix and suffix it was compiled with. If a
+ * directive changes them while rendering, the remaining input can be restored with
+ * `source_from()` and compiled again.
+ */
+class Template {
+private:
+    std::vector<Segment> segments;  ///< Compiled segments in input order.
+    std::string prefix;             ///< Variable prefix used for compilation.
+    std::string suffix;             ///< Variable suffix used for compilation.
+
+public:
+    /** @brief Creates an empty template. */
+    Template() = default;
+
+    /**
+     * @brief Splits the input into text and action segments.
+     *
+     * An inline action without closing suffix is kept as an `unterminated` segment
+     * instead of failing right away: a directive before it may still change the
+     * delimiters, after which the rest of the input is compiled again.
+     *
+     * @param input Raw input text.
+     * @param prefix Variable prefix (e.g. `%%`).
+     * @param suffix Variable suffix (e.g. `%%`).
+     * @return The compiled template.
+     */
+    static Template compile(const std::string& input, const std::string& prefix, const std::string& suffix);
+
+    /** @brief Returns the compiled segments. */
+    const std::vector<Segment>& get_segments() const;
+
+    /**
+     * @brief Checks whether the template was compiled with the given prefix and suffix.
+     * @param prefix Current variable prefix.
+     * @param suffix Current variable suffix.
+     * @return `true` if the template is still valid for these delimiters.
+     */
+    bool matches(const std::string& prefix, const std::string& suffix) const;
+
+    /**
+     * @brief Rebuilds the raw input starting at the given segment.
+     * @param index Index of the first segment to include.
+     * @return The input text the segments were compiled from.
+     */
+    std::string source_from(std::size_t index) const;
+
+    /**
+     * @brief Rebuilds the raw input of a range of segments.
+     * @param first Index of the first segment to include.
+     * @param last Index behind the last segment to include.
+     * @return The input text the segments were compiled from.
+     */
+    std::string source_of(std::size_t first, std::size_t last) const;
+
+    /**
+     * @brief Splits the template into consecutive parts, moving its segments.
+     * @param starts Index of the first segment of every part but the first, ascending.
+     * @return `starts.size() + 1` templates compiled with the same prefix and suffix.
+     */
+    std::vector<Template> split(const std::vector<std::size_t>& starts) &&;
+
+    /** @brief Returns the approximate number of bytes the template occupies in memory. */
+    std::size_t memory_usage() const;
+};
+
+}